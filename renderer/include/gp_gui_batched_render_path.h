@@ -0,0 +1,125 @@
+#ifndef GP_GUI_BATCHED_RENDER_PATH_H
+#define GP_GUI_BATCHED_RENDER_PATH_H
+
+#include "gp_gui_renderer_api.h"
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace gridpro_gui
+{
+    class OpenGL_3_3_RenderKernel;
+    class VertexArrayObject;
+
+    /// @brief Layout of one glMultiDrawElementsIndirect command
+    struct DrawElementsIndirectCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint  baseVertex;
+        GLuint baseInstance;
+    };
+
+    /// @brief Per draw data read by the batched shaders from the SSBO (std430, 144 bytes)
+    struct BatchedDrawData
+    {
+        GLfloat color[4];
+        GLfloat wireframe_color[4];
+        GLfloat position_offset[4];
+        GLfloat position_scale[4];
+        GLuint  pick_id_base;
+        GLuint  padding[3];
+        GLfloat world[16];    /// Scene graph world matrix of the entity (column major)
+    };
+    static_assert(sizeof(BatchedDrawData) == 144, "BatchedDrawData must match the std430 layout of DrawData");
+
+    /// @brief Draws that share a BatchKey are issued with one glMultiDrawElementsIndirect
+    struct BatchKey
+    {
+        std::string shader_name;
+        GLenum   primitive_type;
+        GLenum   wireframe_mode;
+        GLuint   vertex_buffer;
+        GLuint   index_buffer;
+        GLenum   index_type;
+        uint32_t vertex_format;
+
+        bool operator<(const BatchKey& other) const
+        {
+            return std::tie(shader_name, primitive_type, wireframe_mode, vertex_buffer, index_buffer, index_type, vertex_format) <
+                   std::tie(other.shader_name, other.primitive_type, other.wireframe_mode, other.vertex_buffer, other.index_buffer, other.index_type, other.vertex_format);
+        }
+    };
+
+    /// @brief One entity draw, filled by OpenGL_3_3_RenderKernel::prepare_batched_draw
+    struct BatchedDrawRecord
+    {
+        BatchKey key;
+        DrawElementsIndirectCommand command;
+        BatchedDrawData data;
+        VertexArrayObject* vao;
+    };
+
+    ///////////////////////////////////////////////////////
+    ////////// Batched Render Path
+    ///////////////////////////////////////////////////////
+    ///// Groups the entities by shader / primitive type / wireframe mode / arena pages / vertex format
+    ///// and draws every group with one glMultiDrawElementsIndirect. Colors, dequantization and
+    ///// pick id bases are read from an SSBO indexed by a per-draw id (an instanced attribute
+    ///// at location 3 with divisor 1, selected through baseInstance).
+    ///// Kernels that cannot be batched (private buffers, planar layout, no indices) are left to
+    ///// the per-entity path.
+    ///// Usage :
+    ///// path.begin(selection_mode);
+    ///// if(!path.submit(kernel)) kernel.render_selection_mode();
+    ///// path.flush();
+    ///////////////////////////////////////////////////////
+    class BatchedRenderPath
+    {
+      public :
+      BatchedRenderPath();
+     ~BatchedRenderPath();
+
+      BatchedRenderPath(const BatchedRenderPath&) = delete;
+      BatchedRenderPath& operator=(const BatchedRenderPath&) = delete;
+
+      /// @brief Start collecting draws for the display (false) or selection (true) pass
+      void begin(const bool selection_mode);
+
+      /// @brief Queue the kernel's draw. Returns false if the kernel has to be drawn by the per-entity path
+      bool submit(OpenGL_3_3_RenderKernel& kernel);
+
+      /// @brief Upload the commands and draw data and issue one multi draw per batch
+      void flush();
+
+      /// @brief Statistics of the last flush
+      const size_t get_draw_count()  const { return m_draw_count; }
+      const size_t get_batch_count() const { return m_batch_count; }
+
+      private :
+      void init();
+      void reserve_draw_ids(const size_t draw_count);
+      GLuint get_shared_vao(const BatchedDrawRecord& draw);
+      void apply_rasteriser_state(const GLenum& wireframe_mode);
+      void reset_rasteriser_state(const GLenum& wireframe_mode);
+      void release_shared_vaos();
+      void multi_draw(const BatchKey& key, const size_t first_command, const size_t command_count);
+
+      std::map<BatchKey, std::vector<BatchedDrawRecord>> m_batches;
+      std::map<std::tuple<GLuint, GLuint, uint32_t>, GLuint> m_shared_vaos;
+
+      GLuint m_indirect_buffer;
+      GLuint m_draw_data_buffer;
+      GLuint m_draw_id_buffer;
+      size_t m_draw_id_capacity;
+
+      bool   m_selection_mode;
+      bool   m_init_flag;
+      uint64_t m_arena_generation;
+      size_t m_draw_count, m_batch_count;
+    };
+}
+
+#endif // GP_GUI_BATCHED_RENDER_PATH_H
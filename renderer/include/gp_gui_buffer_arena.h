@@ -0,0 +1,92 @@
+#ifndef GP_GUI_BUFFER_ARENA_H
+#define GP_GUI_BUFFER_ARENA_H
+
+#include "gp_gui_renderer_api.h"
+#include <array>
+#include <map>
+#include <vector>
+
+namespace gridpro_gui
+{
+    ///////////////////////////////////////////////////////
+    ////////// GPU Buffer Arena
+    ///////////////////////////////////////////////////////
+    ///// Large vertex and index buffer pages shared by all the VertexArrayObjects.
+    ///// Each page keeps a first-fit free-list (offset -> size) that is coalesced on release,
+    ///// so a scene with thousands of entities uses a handful of buffer objects and draws
+    ///// with base vertex / index offsets into the shared pages.
+    ///// Enabled with _ENABLE_GPU_BUFFER_ARENA_ (gp_gui_typedefs.h). GL thread only.
+    ///// Usage :
+    ///// GpuBufferArena::Allocation range = GpuBufferArena::GetInstance().allocate(GpuBufferArena::VERTEX_POOL, bytes, stride);
+    ///// ----------
+    ///// GpuBufferArena::GetInstance().release(range);
+    ///////////////////////////////////////////////////////
+    class GpuBufferArena
+    {
+      public :
+      enum PoolType {
+          VERTEX_POOL = 0,
+          INDEX_POOL  = 1
+      };
+
+      /// @brief A byte range [offset, offset + size) of a page buffer
+      struct Allocation
+      {
+          GLuint     buffer = 0;
+          GLintptr   offset = 0;
+          GLsizeiptr size   = 0;
+          PoolType   pool   = VERTEX_POOL;
+          const bool is_valid() const { return buffer != 0; }
+      };
+
+      static GpuBufferArena& GetInstance()
+      {
+          static GpuBufferArena instance;
+          return instance;
+      }
+
+      /// @brief Allocate size bytes whose offset is a multiple of alignment (any alignment, e.g. an interleaved stride)
+      Allocation allocate(const PoolType pool, const GLsizeiptr size, const GLsizeiptr alignment);
+
+      /// @brief Allocate ranges of sizes[i] bytes aligned to alignments[i], laid out in order inside a single block of one page
+      /// @details The ranges are released one by one like any other allocation (bulk commits upload them with one write)
+      std::vector<Allocation> allocate_batch(const PoolType pool, const std::vector<GLsizeiptr>& sizes, const std::vector<GLsizeiptr>& alignments);
+
+      /// @brief Return the range to its page. Pages that become empty are deleted (except the first of each pool)
+      void release(Allocation& allocation);
+
+      /// @brief Delete every page (call with the context current once no VertexArrayObject uses the arena)
+      void release_all();
+
+      const size_t     get_num_pages(const PoolType pool)      const { return m_pages[pool].size(); }
+      const GLsizeiptr get_bytes_in_use(const PoolType pool)   const;
+      const GLsizeiptr get_bytes_reserved(const PoolType pool) const;
+
+      /// @brief Incremented whenever a page is created or deleted (page buffer names may be recycled)
+      const uint64_t get_generation() const { return m_generation; }
+
+      private :
+      GpuBufferArena() : m_generation(0) {}
+     ~GpuBufferArena() = default;
+      GpuBufferArena(const GpuBufferArena&) = delete;
+      GpuBufferArena& operator=(const GpuBufferArena&) = delete;
+
+      struct Page
+      {
+          GLuint     buffer;
+          GLsizeiptr size;
+          GLsizeiptr bytes_in_use;
+          std::map<GLintptr, GLsizeiptr> free_blocks;
+      };
+
+      static bool allocate_from_page(Page& page, const GLsizeiptr size, const GLsizeiptr alignment, GLintptr& offset);
+      /// @brief Put [begin, begin + size) back in the free-list of the page, merged with its free neighbours
+      static void free_range(Page& page, GLintptr begin, GLsizeiptr size);
+      Page& create_page(const PoolType pool, const GLsizeiptr min_size);
+
+      std::array<std::vector<Page>, 2> m_pages;
+      uint64_t m_generation;
+    };
+}
+
+#endif // GP_GUI_BUFFER_ARENA_H
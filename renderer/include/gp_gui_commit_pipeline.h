@@ -0,0 +1,73 @@
+#ifndef GP_GUI_COMMIT_PIPELINE_H
+#define GP_GUI_COMMIT_PIPELINE_H
+
+#include <string>
+#include <memory>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "gp_gui_entity_key_table.h"
+
+namespace gridpro_gui
+{
+    class Gp_gui_scene;
+    class GeometryDescriptor;
+    class VertexArrayObject;
+
+    ///////////////////////////////////////////////////////
+    ////////// Geometry Commit Pipeline
+    ///////////////////////////////////////////////////////
+    ///// Descriptors are validated and packed into upload-ready blobs on a worker pool.
+    ///// The scene then creates the entities and runs only the GL uploads on the
+    ///// context thread, within a time budget per update.
+    ///// A submitted descriptor must not be modified until it has been committed.
+    ///// Usage :
+    ///// scene.commit_async("block_1", descriptor);
+    ///// ----------
+    ///// scene.update(layer);   // flushes the ready commits
+    ///////////////////////////////////////////////////////
+    class GeometryCommitPipeline
+    {
+      public :
+      explicit GeometryCommitPipeline(const size_t num_workers = 0);
+     ~GeometryCommitPipeline();
+
+      GeometryCommitPipeline(const GeometryCommitPipeline&) = delete;
+      GeometryCommitPipeline& operator=(const GeometryCommitPipeline&) = delete;
+
+      /// @brief Queue a descriptor for validation and packing
+      void submit(const std::string& entity_key, const std::shared_ptr<GeometryDescriptor>& descriptor);
+
+      /// @brief Commit the prepared descriptors to the scene in submission order (GL thread only)
+      /// @param budget_ms stop once this much time was spent on uploads
+      /// @return number of entities committed
+      size_t flush(Gp_gui_scene& scene, const double& budget_ms);
+
+      /// @brief Number of submitted descriptors that are not committed yet
+      size_t pending() const;
+
+      private :
+      struct CommitJob
+      {
+          EntityKey entity_key;
+          std::shared_ptr<GeometryDescriptor> descriptor;
+          std::shared_ptr<VertexArrayObject>  staged_vao;
+          std::string error;
+          bool ready = false;
+      };
+
+      void worker_loop();
+      static void prepare(CommitJob& job);
+
+      std::vector<std::thread> m_workers;
+      std::deque<std::shared_ptr<CommitJob>> m_waiting;    /// Not yet picked up by a worker
+      std::deque<std::shared_ptr<CommitJob>> m_submitted;  /// Every uncommitted job in submission order
+      mutable std::mutex m_mutex;
+      std::condition_variable m_condition;
+      bool m_stop;
+    };
+}
+
+#endif // GP_GUI_COMMIT_PIPELINE_H
@@ -58,7 +58,7 @@ public:
     public:
 
     std::unordered_map<std::string, Subscription*> SubscribersRegistry;
-    std::unordered_map<uint32_t, std::string>*     EntityIdxKeyMapRegistry;
+    std::unordered_map<uint32_t, EntityKey>*       EntityIdxKeyMapRegistry;
 
     private :
     friend class Gp_gui_scene;
@@ -5,6 +5,8 @@
 #include "ecs.h"
 #include "gp_gui_typedefs.h"
 #include "gp_gui_forward_structs.h"
+#include "gp_gui_slot_map.h"
+#include "gp_gui_entity_key_table.h"
 
 
 namespace gridpro_gui
@@ -21,6 +23,7 @@ namespace gridpro_gui
          template<typename C>
          C* GetComponent()
          {
+           ecs::Entity* entity_ptr = entity();
            if(entity_ptr == nullptr || (entity_ptr->is_valid() == false))
            {
                throw std::runtime_error("Entity is not valid");
@@ -37,6 +40,7 @@ namespace gridpro_gui
          template<typename C>
          C* SetComponent()
          {
+           ecs::Entity* entity_ptr = entity();
            if (entity_ptr == nullptr || (entity_ptr->is_valid() == false))
            {
              throw std::runtime_error("Entity is not valid");
@@ -68,11 +72,25 @@ namespace gridpro_gui
          bool is_valid() const;
          void destroy();
          const std::string& get_key() const;
+         /// @brief Interned key (EntityKeyTable symbol)
+         const EntityKey get_key_symbol() const { return entity_key; }
+         /// @brief Entity id (the id the picks report), stays the same for the lifetime of the entity
+         const uint32_t get_id() const;
+
+         /// @brief Transform relative to the parent entity (scene graph), the geometry is not copied
+         void set_transform(const glm::mat4& local);
+         /// @brief Attach to a parent entity (an invalid handle detaches)
+         void set_parent(const Gp_gui_entity_handle& parent);
+         /// @brief parent world * local (identity if no transform was set)
+         const glm::mat4& get_world_matrix() const;
          
     private:
+        /// @brief Entity in the scene store, nullptr once the entity was removed (even if its slot was reused)
+        ecs::Entity* entity() const;
+
         friend class  Gp_gui_scene;
-        std::string   entity_key;
-        ecs::Entity*  entity_ptr;
+        EntityKey     entity_key;
+        SlotHandle    entity_slot;
         Gp_gui_scene* scene_ptr;
     };
 
@@ -0,0 +1,82 @@
+#ifndef GP_GUI_ENTITY_KEY_TABLE_H
+#define GP_GUI_ENTITY_KEY_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gridpro_gui
+{
+    /// @brief Interned entity key (index into the EntityKeyTable)
+    typedef uint32_t EntityKey;
+    constexpr EntityKey INVALID_ENTITY_KEY = UINT32_MAX;
+
+    ///////////////////////////////////////////////////////
+    ////////// Entity Key Table
+    ///////////////////////////////////////////////////////
+    ///// Interns entity key strings into compact 32 bit symbols. Each distinct key is stored
+    ///// once, the scene registries, entity handles and pick events only carry the symbol and
+    ///// the string is looked up at the API boundary. Symbols are never recycled, so a key
+    ///// that is removed and created again gets its old symbol back. GL / UI thread only.
+    ///// Usage :
+    ///// EntityKey key = EntityKeyTable::GetInstance().intern("block_1");
+    ///// ----------
+    ///// const std::string& name = EntityKeyTable::GetInstance().str(key);
+    ///////////////////////////////////////////////////////
+    class EntityKeyTable
+    {
+      public :
+      static EntityKeyTable& GetInstance()
+      {
+          static EntityKeyTable instance;
+          return instance;
+      }
+
+      /// @brief Symbol of the key, added to the table on first use
+      EntityKey intern(const std::string& key)
+      {
+          std::unordered_map<std::string, EntityKey>::iterator it = m_symbols.find(key);
+          if(it != m_symbols.end()) return it->second;
+
+          const EntityKey symbol = static_cast<EntityKey>(m_strings.size());
+          it = m_symbols.emplace(key, symbol).first;
+          /// Keys of a node based map never move, so the table points at them instead of keeping a second copy
+          m_strings.push_back(&it->first);
+          return symbol;
+      }
+
+      /// @brief Symbol of an already interned key, INVALID_ENTITY_KEY otherwise (the table is not grown)
+      const EntityKey find(const std::string& key) const
+      {
+          std::unordered_map<std::string, EntityKey>::const_iterator it = m_symbols.find(key);
+          return it != m_symbols.end() ? it->second : INVALID_ENTITY_KEY;
+      }
+
+      /// @brief Key string of a symbol (empty for INVALID_ENTITY_KEY)
+      const std::string& str(const EntityKey symbol) const
+      {
+          static const std::string empty;
+          return symbol < m_strings.size() ? *m_strings[symbol] : empty;
+      }
+
+      const size_t size() const { return m_strings.size(); }
+
+      /// @brief Capacity for count more keys (bulk commits)
+      void reserve(const size_t count)
+      {
+          m_symbols.reserve(m_symbols.size() + count);
+          m_strings.reserve(m_strings.size() + count);
+      }
+
+      private :
+      EntityKeyTable() = default;
+      EntityKeyTable(const EntityKeyTable&) = delete;
+      EntityKeyTable& operator=(const EntityKeyTable&) = delete;
+
+      std::unordered_map<std::string, EntityKey> m_symbols;
+      std::vector<const std::string*>            m_strings;
+    };
+}
+
+#endif // GP_GUI_ENTITY_KEY_TABLE_H
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 #include <string>
 #include "gp_gui_scene.h"
+#include "gp_gui_entity_key_table.h"
 
 namespace gridpro_gui
 {
@@ -197,8 +198,8 @@ private:
 class PickEvent : public BaseEvent 
 {
 public:
-PickEvent() : event_type(EventType::None) , picked_color_id(0) , sub_entity_id(0) , entity_id(0), depth(0.0f) {}
-PickEvent(const uint32_t picked_color_id_, EventType input_event) : picked_color_id(picked_color_id_), event_type(input_event)  {}
+PickEvent() : event_type(EventType::None) , picked_color_id(0) , sub_entity_id(0) , entity_id(0), depth(0.0f), world_position(0.0f), normal(0.0f), surface_hit(false), entity_key(INVALID_ENTITY_KEY) {}
+PickEvent(const uint32_t picked_color_id_, EventType input_event) : picked_color_id(picked_color_id_), event_type(input_event), world_position(0.0f), normal(0.0f), surface_hit(false), entity_key(INVALID_ENTITY_KEY) {}
 
 void SetEventType(EventType input_event_type) override { event_type =  input_event_type; }
 
@@ -252,14 +253,27 @@ uint32_t getSubEntityID()
    return this->sub_entity_id; 
 }
 
-std::string getEntityKey() const 
+/// Key string of the picked entity ("NULL_ENTITY" when nothing is picked)
+const std::string& getEntityKey() const 
 {
-   return entity_name;
+   static const std::string null_entity("NULL_ENTITY");
+   return entity_key == INVALID_ENTITY_KEY ? null_entity : EntityKeyTable::GetInstance().str(entity_key);
+}
+
+/// Interned key of the picked entity (INVALID_ENTITY_KEY when nothing is picked)
+EntityKey getEntityKeySymbol() const 
+{
+   return entity_key;
+}
+
+void setEntityKey(const EntityKey& input_key)  
+{
+   entity_key = input_key;
 }
 
 void setEntityKey(const std::string& inputname)  
 {
-   entity_name = inputname;
+   entity_key = EntityKeyTable::GetInstance().intern(inputname);
 }
 
 void setDepth(const float& input_depth)
@@ -272,6 +286,29 @@ float getDepth() const
    return depth;
 }
 
+/// World space point and unit normal of the picked surface (unprojected from the pick depth)
+void setSurface(const glm::vec3& input_position, const glm::vec3& input_normal, const bool& hit)
+{
+   world_position = input_position;
+   normal = input_normal;
+   surface_hit = hit;
+}
+
+glm::vec3 getWorldPosition() const 
+{
+   return world_position;
+}
+
+glm::vec3 getNormal() const 
+{
+   return normal;
+}
+
+bool hasSurface() const 
+{
+   return surface_hit;
+}
+
 inline uint32_t get_entity_id();
 
 private:
@@ -281,7 +318,10 @@ private:
     uint32_t sub_entity_id;
     uint32_t picked_color_id;
     float depth;
-    std::string entity_name;
+    glm::vec3 world_position;
+    glm::vec3 normal;
+    bool surface_hit;
+    EntityKey entity_key;
 };
 
 } // namespace gridpro_gui
@@ -18,16 +18,24 @@ namespace gridpro_gui
       uint32_t _EntityID_;
       uint32_t _Min_ColorID_, _Max_ColorID_;
 
-      unique_color_reservation() {}
+      unique_color_reservation() : _EntityID_(0), _Min_ColorID_(0), _Max_ColorID_(0) {}
 
       unique_color_reservation(uint32_t EntityID, uint32_t Min_ColorID, uint32_t Max_ColorID)
       : _EntityID_(EntityID), _Min_ColorID_(Min_ColorID), _Max_ColorID_(Max_ColorID) {}
 
     };
 
+    /// Entity and sub entity (primitive / vertex) of one pick id
+    struct PickSelection
+    {
+      uint32_t entity_id;
+      uint32_t sub_entity_id;
+    };
+
     struct SceneState 
     {
-      SceneState() : m_render_mode(HLM_NONE), m_projection(glm::mat4(1.0f)), m_view(glm::mat4(1.0f)), m_model(glm::mat4(1.0f)), render_systems_enabled(true) {}
+      SceneState() : m_render_mode(HLM_NONE), m_projection(glm::mat4(1.0f)), m_view(glm::mat4(1.0f)), m_model(glm::mat4(1.0f)),
+                     Position(0.0f), Ambient(0.0f), Diffuse(0.0f), Specular(0.0f), render_systems_enabled(true) {}
      ~SceneState() {}
       enum RenderMode { HLM_NONE = 0 , HLM_RENDER = 1, HLM_SELECT = 2, HLM_RENDER_AND_SELECT = 3 }; 
       /// Scene Render Mode
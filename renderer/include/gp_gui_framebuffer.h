@@ -3,6 +3,8 @@
 #include <vector>
 #include <cstdint>
 #include "gp_gui_renderer_api.h"
+#include "gp_gui_instrumentation.h"
+#include <glm/glm.hpp>
 
 namespace gridpro_gui 
 {
@@ -16,19 +18,207 @@ class framebuffer
   enum class ScanMode {PER_PIXEL, LEFT_RIGHT, SPIRAL};
   ScanMode scan_mode;
 
+  /// SYNCHRONOUS reads the pick image of this frame with blocking glReadPixels.
+  /// ASYNCHRONOUS reads into a ring of pixel pack buffers and uses the image of an earlier frame (no stall).
+  enum class ReadbackMode {SYNCHRONOUS, ASYNCHRONOUS};
+
+  /// RGB_BACK_BUFFER renders RGB encoded ids (24 bits) into the back buffer.
+  /// INTEGER_ID_FBO renders raw 32 bit ids into the R32UI attachment of an offscreen framebuffer (never touches the visible frame).
+  enum class PickTarget {RGB_BACK_BUFFER, INTEGER_ID_FBO};
+
+  /// @brief Fix the region read back this frame and scissor the pick draws to it (call before the draws)
+  /// @param view_projection projection * view the pass is drawn with, it travels with the image (see image_inverse_view_projection)
+  void begin_pick_pass(const glm::mat4& view_projection);
+  /// @brief Read back the pick region (ends the scissor set by begin_pick_pass)
   void update_current_frame_buffer();
+
+  /// @brief Select where the pick pass renders (the offscreen framebuffer is kept until release())
+  /// @note   takes effect at the next begin_pick_pass() so a pass never mixes both id encodings
+  void set_pick_target(const PickTarget target) { requested_pick_target = target; }
+  const PickTarget get_pick_target() const { return requested_pick_target; }
+  /// @brief True if the select shaders have to write raw 32 bit ids (shader selection of the render kernels)
+  const bool uses_integer_ids() const { return pick_target == PickTarget::INTEGER_ID_FBO; }
+
+  /// @brief Depth peeled pick pass : the INTEGER_ID_FBO pass is rendered layers times, each layer keeping the
+  /// fragments behind the previous one, so hidden faces can be picked (1 = front most ids only, up to GL_PICK_MAX_PEEL_LAYERS)
+  /// @note  layers are read back synchronously, the RGB back buffer target always renders a single layer
+  void set_depth_peel_layers(const uint32_t layers);
+  const uint32_t get_depth_peel_layers() const { return peel_layers; }
+  /// @brief Layers the current pick pass renders (valid after begin_pick_pass)
+  const uint32_t pick_layer_count() const { return uses_integer_ids() ? peel_layers : 1; }
+  /// @brief Layer being rendered (the select shaders discard fragments in front of the previous layer when > 0)
+  const uint32_t current_peel_layer() const { return peel_layer; }
+  /// @brief Attach the depth target of the layer and bind the previous layer's depth (call before the layer's draws)
+  void begin_peel_layer(const uint32_t layer);
+  /// @brief Read back the layer, false if it holds no id (deeper layers would be empty too)
+  const bool end_peel_layer(const uint32_t layer);
+
+  /// One id of a peeled id stack and its window depth
+  struct LayerHit
+  {
+    uint32_t id;
+    float    depth;
+  };
+  /// @brief Ids under the cursor front to back, one per peeled layer (empty layers skipped)
+  std::vector<LayerHit> id_stack_at(const float current_mouse_x, const float current_mouse_y) const;
+  /// @brief Distinct ids of all peeled layers in the rectangle spanned by two cursor positions, ordered by their nearest depth
+  std::vector<LayerHit> id_stack_in_rectangle(const float x0, const float y0, const float x1, const float y1) const;
+
+  /// @brief Region of interest mode : only a window of width x height around the last requested cursor
+  /// position is rendered and read back. Pixels outside the window read as 0 (no hit).
+  void enable_region_of_interest(const bool enable) { roi_enabled = enable; }
+  const bool is_region_of_interest_enabled() const { return roi_enabled; }
+  void set_region_of_interest_size(const uint32_t width, const uint32_t height);
+  /// @brief Center the region of interest of the next pick pass on the cursor (window coordinates, y down)
+  void request_region_of_interest(const float current_mouse_x, const float current_mouse_y);
+
+  /// @brief Select the readback mode (the ring is kept until release())
+  void set_readback_mode(const ReadbackMode mode);
+  const ReadbackMode get_readback_mode() const { return readback_mode; }
+
+  /// @brief Maximum age in frames of the pick image in ASYNCHRONOUS mode (1 .. GL_PICK_READBACK_MAX_LATENCY)
+  void set_readback_latency(const uint32_t frames);
+  const uint32_t get_readback_latency() const { return readback_latency; }
+
+  /// @brief Age in frames of the pick image currently held (0 in SYNCHRONOUS mode)
+  const uint32_t current_image_latency() const { return image_latency; }
+
+  /// @brief Fence waits on the pixel pack ring (a stalled wait means the image was needed before the GPU finished it)
+  const Instrumentation::FenceWaitStatistics& get_readback_statistics() const { return readback_statistics; }
+
+  /// @brief Hash of the region and target the next pick pass would use (input of the SelectionPassScheduler)
+  const uint64_t pick_pass_signature() const;
+
+  /// @brief Consume a finished asynchronous readback on a frame without pick pass (non blocking)
+  void poll_pending_readbacks();
+
+  /// @brief Delete the pixel pack ring and the offscreen pick framebuffer (call with the context current)
+  void release();
   uint32_t color_id_at(const float current_mouse_x, const float current_mouse_y);
   std::vector<uint32_t> pick_matrix(const float current_mouse_x, const float current_mouse_y, const float pick_matrix_length, const float pick_matrix_width);
   uint32_t pixel_at(const float current_mouse_x, const float current_mouse_y);
   const std::vector<unsigned char>* data();
   float depth_at(const float current_mouse_x, const float current_mouse_y);
+
+  /// @brief Distinct pick ids in [id_begin, id_end) inside the rectangle spanned by two cursor positions (ascending order)
+  /// @note  Only the held image is scanned (the region of interest in that mode)
+  std::vector<uint32_t> ids_in_rectangle(const float x0, const float y0, const float x1, const float y1, const uint32_t id_begin, const uint32_t id_end);
+  /// @brief Distinct pick ids in [id_begin, id_end) inside a lasso polygon of cursor positions (even-odd rule, ascending order)
+  std::vector<uint32_t> ids_in_lasso(const std::vector<glm::vec2>& lasso, const uint32_t id_begin, const uint32_t id_end);
   float last_hit_depth();
 
+  /// One pixel of the pick image unprojected to world space (hit is false on background pixels)
+  struct SurfaceSample
+  {
+    glm::vec3 position;
+    glm::vec3 normal;
+    float     depth;
+    bool      hit;
+  };
+  /// @brief inverse(projection * view) the current pick image was drawn with (an asynchronous readback may be frames old)
+  const glm::mat4& image_inverse_view_projection() const { return image_inverse_vp; }
+  /// @brief World position / normal under the cursor, inverse_view_projection = inverse(projection * view)
+  /// @note  pass image_inverse_view_projection() so a moving camera does not skew the result
+  /// @note  multiply by inverse(model) for the coordinates of the descriptors
+  SurfaceSample surface_at(const float current_mouse_x, const float current_mouse_y, const glm::mat4& inverse_view_projection);
+  /// @brief Surface of the last pick matrix hit (the pixel last_hit_depth() reads)
+  SurfaceSample last_hit_surface(const glm::mat4& inverse_view_projection);
+  /// @brief Every pixel of the rectangle spanned by two cursor positions, unprojected in batch (SIMD)
+  /// @details rows from the top of the rectangle, index = (y - top) * width + (x - left), width / height are the clamped size
+  std::vector<SurfaceSample> surface_in_rectangle(const float x0, const float y0, const float x1, const float y1, const glm::mat4& inverse_view_projection,
+                                                  uint32_t& width, uint32_t& height);
+
  private :
+ /// One in flight readback of the color and depth images
+ /// Rectangle of the viewport in GL window coordinates (origin bottom left)
+ struct PickRegion
+ {
+   int32_t  x = 0, y = 0;
+   uint32_t width = 0, height = 0;
+   uint32_t viewport_height = 0;
+   int32_t  viewport_x = 0, viewport_y = 0;
+   uint32_t viewport_width = 0;
+ };
+
+ /// One in flight readback of the color and depth images
+ struct PixelPackSlot
+ {
+   GLuint     color_pbo = 0, depth_pbo = 0;
+   GLsync     fence     = nullptr;
+   GLsizeiptr capacity  = 0;
+   bool       integer_ids = false;
+   PickRegion region;
+   uint64_t   frame = 0;
+   glm::mat4  view_projection = glm::mat4(1.0f);
+ };
+
+ PickRegion compute_read_region() const;
+ /// @brief (Re)build the offscreen pick framebuffer when the viewport size changes
+ void ensure_id_framebuffer(const uint32_t width, const uint32_t height);
+ void release_id_framebuffer();
+ void ensure_peel_depth_textures();
+ void release_peel_depth_textures();
+ /// @brief Index of the cursor in the peeled layers (-1 if outside of them)
+ int64_t peel_index(const float current_mouse_x, const float current_mouse_y) const;
+ void release_pixel_pack_ring();
+ /// @brief Read format of the current pick target
+ void pixel_read_format(GLenum& format, GLenum& type) const;
+ void set_image_region(const PickRegion& region);
+ /// @brief Adopt the view projection of the pass the pick image comes from
+ void set_image_view_projection(const glm::mat4& view_projection);
+ /// @brief Mark the ids of image pixels [first, first + count) of one row in the id bitset (SIMD scan)
+ void scan_id_span(const size_t first, const size_t count, const uint32_t id_begin, const uint32_t id_end, std::vector<uint64_t>& id_bits) const;
+ /// @brief Ids of the set bits of an id bitset (bit i stands for id_begin + i), ascending
+ static std::vector<uint32_t> collect_id_bits(const std::vector<uint64_t>& id_bits, const uint32_t id_begin);
+ /// @brief World positions of image pixels [first, first + count) of one row (SIMD), w <= 0 marks background
+ void unproject_span(const int64_t row, const int64_t first_col, const size_t count, const glm::mat4& inverse_view_projection,
+                     float* x, float* y, float* z, float* w) const;
+ /// @brief Image row of a cursor y coordinate (may be outside of the image)
+ int64_t image_row(const float current_mouse_y) const;
+ /// @brief Index of the mouse position in the image (-1 if outside of it)
+ int64_t image_index(const float current_mouse_x, const float current_mouse_y) const;
+
+ void read_synchronous();
+ void read_asynchronous();
+ void issue_readback(PixelPackSlot& slot);
+ void consume_readback(PixelPackSlot& slot, const bool blocking);
+
+ bool roi_enabled, roi_requested, pick_pass_open;
+ uint32_t roi_width, roi_height;
+ float roi_cursor_x, roi_cursor_y;
+ PickRegion read_region;
+
+ PickTarget requested_pick_target, pick_target;
+ GLuint id_fbo, id_color_renderbuffer, id_depth_renderbuffer;
+ uint32_t id_fbo_width, id_fbo_height;
+ GLint previous_draw_fbo, previous_read_fbo;
+ bool image_integer_ids;
+
+ /// Ping pong depth textures of the peeled layers and the ids / depths read back per layer (peel_region, front to back)
+ uint32_t peel_layers, peel_layer, peeled_layer_count;
+ GLuint   peel_depth_textures[2];
+ uint32_t peel_texture_width, peel_texture_height;
+ PickRegion peel_region;
+ std::vector<std::vector<uint32_t>> peeled_ids;
+ std::vector<std::vector<float>>    peeled_depths;
+
+ ReadbackMode readback_mode;
+ uint32_t readback_latency;
+ uint32_t image_latency;
+ uint64_t frame_counter;
+ std::vector<PixelPackSlot> pixel_pack_ring;
+ /// View projection of the pass being drawn and of the pick image (with its inverse)
+ glm::mat4 pass_vp, image_vp, image_inverse_vp;
+ Instrumentation::FenceWaitStatistics readback_statistics;
+
  std::vector<unsigned char> framebufferData;
  std::vector<float> DepthBufferData;
  uint32_t framebufferWidth ;
  uint32_t framebufferHeight;
+ int32_t  framebufferX, framebufferY;
+ uint32_t viewportHeight;
+ int32_t  viewportX, viewportY;
+ uint32_t viewportWidth;
  uint32_t color_id;
  float last_hit_x, last_hit_y;
 
@@ -22,7 +22,9 @@
 #include <cstdint>
 #include <string>
 #include <iostream>
+#include <algorithm>
 #include <array>
+#include <limits>
 
 #include "gp_gui_typedefs.h"
 
@@ -107,6 +109,29 @@ public:
             INDEX_ARRAY    = GL_INDEX_ARRAY
         };
 
+        /// @brief  Enumeration for vertex buffer layouts
+        /// @details PLANAR uploads positions, normals and colors as separate blocks of one VBO
+        /// @details INTERLEAVED packs position + normal + color of a vertex into one stride
+        enum VertexLayout {
+            PLANAR      = GL_VERTEX_LAYOUT_PLANAR,
+            INTERLEAVED = GL_VERTEX_LAYOUT_INTERLEAVED
+        };
+
+        /// @brief  Enumeration for vertex compression
+        /// @details QUANTIZED stores positions as 16 bit unorm relative to the bounding box,
+        /// @details normals as 2x16 bit octahedral snorm and indices as 16 bit when the vertex count allows
+        enum VertexCompression {
+            COMPRESSION_NONE      = GL_VERTEX_COMPRESSION_NONE,
+            COMPRESSION_QUANTIZED = GL_VERTEX_COMPRESSION_QUANTIZED
+        };
+
+        /// @brief  Enumeration for buffer usage hints
+        /// @details STREAM routes the buffer updates through the persistently mapped streaming ring
+        enum BufferUsage {
+            USAGE_STATIC = GL_BUFFER_USAGE_STATIC,
+            USAGE_STREAM = GL_BUFFER_USAGE_STREAM
+        };
+
         /// @brief  Enumeration for dirty flags
         enum DirtyFlags {
             DIRTY_NONE           = 0,
@@ -117,7 +142,9 @@ public:
             DIRTY_SHADE_MODEL    = 1 << 4,
             DIRTY_COLOR_SCHEME   = 1 << 5,
             DIRTY_PICK_SCHEME    = 1 << 6,
-            DIRTY_ALL            = DIRTY_POSITIONS | DIRTY_NORMALS | DIRTY_COLORS | DIRTY_INDICES | DIRTY_SHADE_MODEL | DIRTY_COLOR_SCHEME | DIRTY_PICK_SCHEME
+            DIRTY_VERTEX_LAYOUT  = 1 << 7,
+            DIRTY_INSTANCES      = 1 << 8,
+            DIRTY_ALL            = DIRTY_POSITIONS | DIRTY_NORMALS | DIRTY_COLORS | DIRTY_INDICES | DIRTY_SHADE_MODEL | DIRTY_COLOR_SCHEME | DIRTY_PICK_SCHEME | DIRTY_VERTEX_LAYOUT | DIRTY_INSTANCES
             
         };
         
@@ -125,8 +152,13 @@ public:
             uint32_t EntityID;
             uint32_t start, end;
         }; 
+
+        /// @brief Half open byte interval [begin, end) of an attribute array modified since the last upload
+        struct DirtyRange {
+            size_t begin, end;
+        };
    
-        PrimitiveSetInstance(const std::string& _InstanceName,  GLenum _PrimitiveType) : InstanceName(_InstanceName), primitiveType(static_cast<PrimitiveType>(_PrimitiveType)), colorFormat(RGB), dirtyFlags(DIRTY_NONE), colorScheme(PER_PRIMITIVE_SET), pickScheme(PICK_NONE) , shadingModel(FLAT) , materialProperty(COLOR_MATERIAL), wireframecolor(0, 0, 200, 255)
+        PrimitiveSetInstance(const std::string& _InstanceName,  GLenum _PrimitiveType) : InstanceName(_InstanceName), primitiveType(static_cast<PrimitiveType>(_PrimitiveType)), colorFormat(RGB), dirtyFlags(DIRTY_NONE), geometryVersion(0), colorScheme(PER_PRIMITIVE_SET), pickScheme(PICK_NONE) , shadingModel(FLAT) , materialProperty(COLOR_MATERIAL), vertexLayout(PLANAR), vertexCompression(COMPRESSION_NONE), bufferUsage(USAGE_STATIC), wireframecolor(0, 0, 200, 255)
         {
             positions = std::make_shared<std::vector<float>>(0);
             normals   = std::make_shared<std::vector<float>>(0);
@@ -184,8 +216,8 @@ public:
         const PickScheme get_pick_scheme() const      { return pickScheme; }
         const GLenum get_pick_scheme_enum() const     { return static_cast<GLenum>(pickScheme); }   
 
-        /// @brief Get Pickable entites count for the current PrimitiveSet
-        const size_t get_pickable_entities_count() const
+        /// @brief Get Pickable entites count of one instance of the current PrimitiveSet
+        const size_t get_pickable_entities_per_instance() const
         {
             size_t count = 0;
             switch(pickScheme)
@@ -199,6 +231,69 @@ public:
             return count;
         }
 
+        /// @brief Get Pickable entites count for the current PrimitiveSet (every instance has its own ids)
+        const size_t get_pickable_entities_count() const
+        {
+            return get_pickable_entities_per_instance() * std::max<size_t>(1, get_num_instances());
+        }
+
+        /// @brief Hardware instancing : the primitive set is drawn once per instance transform, on top of the entity world matrix
+        /// @param transforms 16 floats (column major 4x4) per instance
+        /// @param colors     optional RGBA per instance, replaces the primitive set color in display mode
+        /// @details The sub entity id of a pick is instance * get_pickable_entities_per_instance() + vertex / primitive id (see decode_instance_pick)
+        void set_instances(const std::vector<float>& transforms, const std::vector<uint8_t>& colors = std::vector<uint8_t>())
+        {
+            if(transforms.size() % 16 != 0)
+                throw std::runtime_error("PrimitiveSet [" + InstanceName + "] : instance transforms are not a multiple of 16 floats");
+            if(!colors.empty() && colors.size() != (transforms.size() / 16) * 4)
+                throw std::runtime_error("PrimitiveSet [" + InstanceName + "] : instance colors must hold one RGBA value per instance");
+
+            instanceTransforms = transforms;
+            instanceColors     = colors;
+            setDirty(DIRTY_INSTANCES);
+        }
+
+        /// @brief Append one instance (without a color it is drawn with the primitive set color)
+        void push_instance(const std::array<float, 16>& transform)
+        {
+            instanceTransforms.insert(instanceTransforms.end(), transform.begin(), transform.end());
+            if(!instanceColors.empty()) instanceColors.insert(instanceColors.end(), { color.r, color.g, color.b, color.a });
+            setDirty(DIRTY_INSTANCES);
+        }
+
+        void push_instance(const std::array<float, 16>& transform, const std::array<uint8_t, 4>& rgba)
+        {
+            /// The instances pushed without a color so far keep the primitive set color
+            if(instanceColors.empty())
+                for(size_t i = 0; i < get_num_instances(); ++i) instanceColors.insert(instanceColors.end(), { color.r, color.g, color.b, color.a });
+            instanceTransforms.insert(instanceTransforms.end(), transform.begin(), transform.end());
+            instanceColors.insert(instanceColors.end(), rgba.begin(), rgba.end());
+            setDirty(DIRTY_INSTANCES);
+        }
+
+        /// @brief Back to a single, non instanced draw
+        void clear_instances()
+        {
+            if(instanceTransforms.empty()) return;
+            instanceTransforms.clear();
+            instanceColors.clear();
+            setDirty(DIRTY_INSTANCES);
+        }
+
+        const bool   is_instanced() const                           { return !instanceTransforms.empty(); }
+        const size_t get_num_instances() const                      { return instanceTransforms.size() / 16; }
+        const bool   has_instance_colors() const                    { return !instanceColors.empty(); }
+        const std::vector<float>&   get_instance_transforms() const { return instanceTransforms; }
+        const std::vector<uint8_t>& get_instance_colors() const     { return instanceColors; }
+
+        /// @brief Split the sub entity id of a pick into the instance and the vertex / primitive inside it (0 for PICK_GEOMETRY)
+        void decode_instance_pick(const uint32_t sub_entity_id, uint32_t& instance, uint32_t& element) const
+        {
+            const uint32_t stride = static_cast<uint32_t>(std::max<size_t>(1, get_pickable_entities_per_instance()));
+            instance = sub_entity_id / stride;
+            element  = sub_entity_id % stride;
+        }
+
         /// @brief Set Min and Max Pickable entites for the current PrimitiveSet
         /// @param const min(starting index) generated by SceneManager
         /// @param max(ending index) evaluated and passed to SceneManager
@@ -239,6 +334,36 @@ public:
         const WireframeMode get_wireframe_mode() const { return wireframeMode; }
         const GLenum get_wireframe_mode_enum() const   { return static_cast<GLenum>(wireframeMode); }
 
+        /// @brief Set Vertex Buffer Layout (planar by default)
+        /// @param layout
+        void set_vertex_layout(VertexLayout layout)    { if(vertexLayout != layout) { vertexLayout = layout; setDirty(DIRTY_VERTEX_LAYOUT); } }
+        void set_vertex_layout(GLenum layout)          { set_vertex_layout(static_cast<VertexLayout>(layout)); }
+
+        /// @brief Get Vertex Buffer Layout
+        const VertexLayout get_vertex_layout() const   { return vertexLayout; }
+        const GLenum get_vertex_layout_enum() const    { return static_cast<GLenum>(vertexLayout); }
+        const bool is_interleaved() const              { return vertexLayout == INTERLEAVED; }
+
+        /// @brief Set Vertex Compression (uncompressed by default)
+        /// @param compression
+        void set_vertex_compression(VertexCompression compression) { if(vertexCompression != compression) { vertexCompression = compression; setDirty(DIRTY_VERTEX_LAYOUT); } }
+        void set_vertex_compression(GLenum compression)            { set_vertex_compression(static_cast<VertexCompression>(compression)); }
+
+        /// @brief Get Vertex Compression
+        const VertexCompression get_vertex_compression() const     { return vertexCompression; }
+        const GLenum get_vertex_compression_enum() const           { return static_cast<GLenum>(vertexCompression); }
+        const bool is_quantized() const                            { return vertexCompression == COMPRESSION_QUANTIZED; }
+
+        /// @brief Set Buffer Usage (static by default, stream for geometry rewritten every frame)
+        /// @param usage
+        void set_buffer_usage(BufferUsage usage)       { if(bufferUsage != usage) { bufferUsage = usage; setDirty(DIRTY_VERTEX_LAYOUT); } }
+        void set_buffer_usage(GLenum usage)            { set_buffer_usage(static_cast<BufferUsage>(usage)); }
+
+        /// @brief Get Buffer Usage
+        const BufferUsage get_buffer_usage() const     { return bufferUsage; }
+        const GLenum get_buffer_usage_enum() const     { return static_cast<GLenum>(bufferUsage); }
+        const bool is_streamed() const                 { return bufferUsage == USAGE_STREAM; }
+
         /// @brief Get Weak Pointer to the Positions
         std::weak_ptr<std::vector<float>> get_position_weak_ptr()  const   
         { return positions; }
@@ -257,19 +382,19 @@ public:
 
         /// @brief Share Pointer to the Positions
         void share_position_shared_ptr(std::shared_ptr<std::vector<float>>& in_position) 
-        { positions = in_position; }
+        { positions = in_position; setDirty(DIRTY_POSITIONS); }
 
         /// @brief Share Pointer to the Normals
         void share_normals_shared_ptr(std::shared_ptr<std::vector<float>>& in_normal) 
-        { normals = in_normal; }
+        { normals = in_normal;     setDirty(DIRTY_NORMALS);   }
 
         /// @brief Share Pointer to the Colors
         void share_colors_shared_ptr(std::shared_ptr<std::vector<uint8_t>>& in_color) 
-        { colors = in_color; }
+        { colors = in_color;       setDirty(DIRTY_COLORS);    }
 
         /// @brief SharePointer to the Indices
         void share_indices_shared_ptr(std::shared_ptr<std::vector<uint32_t>>& in_indices) 
-        { indices = in_indices; }
+        { indices = in_indices;    setDirty(DIRTY_INDICES);   }
 
 
         /// @brief Get the number of vertices
@@ -310,7 +435,7 @@ public:
             colors    = std::make_shared<std::vector<uint8_t>>(0);
             indices   = std::make_shared<std::vector<uint32_t>>(0);
 
-            dirtyFlags = DIRTY_ALL;
+            setDirty(DIRTY_ALL);
         }
 
         /// @brief clear the primitive set
@@ -320,28 +445,28 @@ public:
         }        
         
         void clear_positions() 
-        { positions->resize(0); dirtyFlags |= DIRTY_POSITIONS; }
+        { positions->resize(0); setDirty(DIRTY_POSITIONS); }
 
         void clear_normals() 
-        { normals->resize(0);   dirtyFlags |= DIRTY_NORMALS;   }
+        { normals->resize(0);   setDirty(DIRTY_NORMALS);   }
 
         void clear_colors() 
-        { colors->resize(0);    dirtyFlags |= DIRTY_COLORS;    }
+        { colors->resize(0);    setDirty(DIRTY_COLORS);    }
 
         void clear_indices() 
-        { indices->resize(0);   dirtyFlags |= DIRTY_INDICES;   }
+        { indices->resize(0);   setDirty(DIRTY_INDICES);   }
 
         void release_positions_ref() 
-        { positions.reset(); positions = std::make_shared<std::vector<float>>(0);     dirtyFlags |= DIRTY_POSITIONS; }
+        { positions.reset(); positions = std::make_shared<std::vector<float>>(0);     setDirty(DIRTY_POSITIONS); }
 
         void release_normals_ref() 
-        { normals.reset();   normals   = std::make_shared<std::vector<float>>(0);     dirtyFlags |= DIRTY_NORMALS;   }
+        { normals.reset();   normals   = std::make_shared<std::vector<float>>(0);     setDirty(DIRTY_NORMALS);   }
 
         void release_colors_ref() 
-        { colors.reset();    colors    = std::make_shared<std::vector<uint8_t>>(0);   dirtyFlags |= DIRTY_COLORS;    }
+        { colors.reset();    colors    = std::make_shared<std::vector<uint8_t>>(0);   setDirty(DIRTY_COLORS);    }
 
         void release_indices_ref() 
-        { indices.reset();   indices   = std::make_shared<std::vector<uint32_t>>(0);  dirtyFlags |= DIRTY_INDICES;   }
+        { indices.reset();   indices   = std::make_shared<std::vector<uint32_t>>(0);  setDirty(DIRTY_INDICES);   }
 
 
         /// @brief Get Dirty Flags
@@ -353,17 +478,79 @@ public:
 
         /// @brief Set and Clear Dirty Flags
         /// @param flag
-        void setDirty(DirtyFlags flag)                { dirtyFlags |= static_cast<int32_t>(flag); }
-        void setDirty(uint32_t flag)                  { dirtyFlags |= flag; }
+        void setDirty(DirtyFlags flag)                { setDirty(static_cast<uint32_t>(flag)); }
+        void setDirty(uint32_t flag)                  
+        { 
+            dirtyFlags |= flag; 
+            ++geometryVersion; 
+            /// Instanced sets drawing these arrays have to upload them as well
+            const uint32_t shared_flags = flag & (DIRTY_POSITIONS | DIRTY_NORMALS | DIRTY_COLORS | DIRTY_INDICES);
+            if(shared_flags) for_each_instanced_set([this, shared_flags](PrimitiveSetInstance& set) { set.share_arrays_from(*this, shared_flags); set.setDirty(shared_flags); });
+        }
         
         const uint32_t getDirtyFlags() const          { return dirtyFlags; }
 
+        /// @brief Incremented by every modification of the set (unlike the dirty flags it is not reset by an upload)
+        const uint64_t get_geometry_version() const   { return geometryVersion; }
+
         /// @brief Clear Dirty Flags of a specific flag
-        void clearDirty(DirtyFlags flag)              { dirtyFlags &= ~static_cast<int32_t>(flag); }
-        void clearDirty(uint32_t flag)                { dirtyFlags &= ~flag; }
+        void clearDirty(DirtyFlags flag)              { clearDirty(static_cast<uint32_t>(flag)); }
+        void clearDirty(uint32_t flag)                
+        { 
+            dirtyFlags &= ~flag; 
+            if(flag & DIRTY_POSITIONS) dirtyRanges[0].clear();
+            if(flag & DIRTY_NORMALS)   dirtyRanges[1].clear();
+            if(flag & DIRTY_COLORS)    dirtyRanges[2].clear();
+            if(flag & DIRTY_INDICES)   dirtyRanges[3].clear();
+        }
         
         /// @brief Clear all dirty flags
-        void clearDirty()                             { dirtyFlags = 0; }
+        void clearDirty()                             { dirtyFlags = 0; for(auto& ranges : dirtyRanges) ranges.clear(); }
+
+        /// @brief Record a modified byte interval [begin, end) of an attribute array
+        /// @details Intervals are kept sorted and overlapping / adjacent intervals are merged
+        /// @note    Does not set the dirty flag, use setDirty() as well
+        void add_dirty_range(VertexArrayType type, const size_t begin, const size_t end)
+        {
+            if(begin >= end) return;
+            for_each_instanced_set([type, begin, end](PrimitiveSetInstance& set) { set.add_dirty_range(type, begin, end); });
+            std::vector<DirtyRange>& ranges = dirtyRanges[dirty_range_slot(type)];
+
+            /// Fast path for appends and repeated writes to the last interval
+            if(!ranges.empty() && ranges.back().begin <= begin && begin <= ranges.back().end)
+            {
+                if(end > ranges.back().end) ranges.back().end = end;
+                return;
+            }
+
+            std::vector<DirtyRange> merged;
+            merged.reserve(ranges.size() + 1);
+            DirtyRange incoming = { begin, end };
+            bool inserted = false;
+            for(const DirtyRange& range : ranges)
+            {
+                if(range.end < incoming.begin)      { merged.push_back(range); }
+                else if(incoming.end < range.begin) { if(!inserted) { merged.push_back(incoming); inserted = true; } merged.push_back(range); }
+                else                                { incoming.begin = std::min(incoming.begin, range.begin); incoming.end = std::max(incoming.end, range.end); }
+            }
+            if(!inserted) merged.push_back(incoming);
+            ranges.swap(merged);
+        }
+
+        /// @brief Mark a whole attribute array as modified (flag + one interval covering the array)
+        void mark_array_dirty(VertexArrayType type)
+        {
+            static const uint32_t flags[4] = { DIRTY_POSITIONS, DIRTY_NORMALS, DIRTY_COLORS, DIRTY_INDICES };
+            const size_t slot = dirty_range_slot(type);
+            dirtyFlags |= flags[slot];
+            ++geometryVersion;
+            dirtyRanges[slot].assign(1, DirtyRange{ 0, std::numeric_limits<size_t>::max() });
+            for_each_instanced_set([this, type, slot](PrimitiveSetInstance& set) { set.share_arrays_from(*this, flags[slot]); set.mark_array_dirty(type); });
+        }
+
+        /// @brief Get the modified byte intervals of an attribute array
+        /// @details An empty list with the dirty flag set means the whole array is modified
+        const std::vector<DirtyRange>& get_dirty_ranges(VertexArrayType type) const { return dirtyRanges[dirty_range_slot(type)]; }
 
         /// @brief Validate the primitive set
         const bool isDrawable() const                 { return positions->size() > 0 && primitiveType != PrimitiveType::NONE; }
@@ -475,6 +662,15 @@ public:
             /// @brief Pick scheme for the primitive set
             PickScheme pickScheme;  
 
+            /// @brief Vertex buffer layout for the primitive set
+            VertexLayout vertexLayout;
+
+            /// @brief Vertex compression for the primitive set
+            VertexCompression vertexCompression;
+
+            /// @brief Buffer usage hint for the primitive set
+            BufferUsage bufferUsage;
+
             /// @brief Pick color reservation for the primitive set
             struct unique_color_reservation  pick_color_reservation; 
         
@@ -490,8 +686,53 @@ public:
             /// @brief Indices for this primitive set
             std::shared_ptr<std::vector<uint32_t>> indices;   
         
+            /// @brief Per instance transforms (16 floats, column major) and optional RGBA colors, empty when not instanced
+            std::vector<float>   instanceTransforms;
+            std::vector<uint8_t> instanceColors;
+
             /// @brief Flags to indicate which data has changed
             uint32_t dirtyFlags; 
+
+            /// @brief Modification counter (see get_geometry_version)
+            uint64_t geometryVersion;
+
+            /// @brief Modified byte intervals of positions, normals, colors and indices
+            std::array<std::vector<DirtyRange>, 4> dirtyRanges;
+
+            /// @brief Instanced sets created from this one (set_new_instanced_primitive_set), they share its attribute arrays
+            std::vector<std::weak_ptr<PrimitiveSetInstance>> instancedSets;
+
+            /// @brief Point the flagged arrays at the source's (the source may have replaced them instead of editing in place)
+            void share_arrays_from(const PrimitiveSetInstance& source, const uint32_t flags)
+            {
+                if(flags & DIRTY_POSITIONS) positions = source.positions;
+                if(flags & DIRTY_NORMALS)   normals   = source.normals;
+                if(flags & DIRTY_COLORS)    colors    = source.colors;
+                if(flags & DIRTY_INDICES)   indices   = source.indices;
+            }
+
+            /// @brief Visit the live instanced sets (expired ones are dropped)
+            template<typename Visitor>
+            void for_each_instanced_set(Visitor visitor)
+            {
+                for(size_t i = 0; i < instancedSets.size(); )
+                {
+                    if(std::shared_ptr<PrimitiveSetInstance> set = instancedSets[i].lock()) { visitor(*set); ++i; }
+                    else                                                                    { instancedSets.erase(instancedSets.begin() + i); }
+                }
+            }
+
+            static size_t dirty_range_slot(VertexArrayType type)
+            {
+                switch(type)
+                {
+                    case POSITION_ARRAY: return 0;
+                    case NORMAL_ARRAY:   return 1;
+                    case COLOR_ARRAY:    return 2;
+                    case INDEX_ARRAY:    return 3;
+                }
+                return 0;
+            }
             
             public :
             /// @brief Color if(if Mono Color Scheme)
@@ -529,7 +770,18 @@ public:
         return currentPrimitiveSet->pick_color_reservation.end; 
     }
     
+    /// @brief Number of ids in [reserve start, reserve end] for the current pick scheme and primitive count
+    const uint32_t get_color_id_reserve_count() const
+    {
+        uint32_t reserve = currentPrimitiveSet->get_pickable_entities_count();
+        if(reserve == 1) reserve = 0;
+        return reserve + 1;
+    }
+    
     void set_pick_scheme(const GLenum& scheme)       { currentPrimitiveSet->set_pick_scheme(scheme); }
+    void set_vertex_layout(const GLenum& layout)     { currentPrimitiveSet->set_vertex_layout(layout); }
+    void set_vertex_compression(const GLenum& mode)  { currentPrimitiveSet->set_vertex_compression(mode); }
+    void set_buffer_usage(const GLenum& usage)       { currentPrimitiveSet->set_buffer_usage(usage); }
 
     /// @brief Constructor
     GeometryDescriptor();
@@ -570,6 +822,12 @@ public:
     /// @brief Set the current primitive set
     __INLINE__ void set_current_primitive_set(const std::string& name, GLenum Primitivetype);
 
+    /// @brief Create an instanced primitive set drawing the geometry of another one (positions, normals, colors and
+    /// @brief indices are shared, not copied) and make it current. Add the instances with set_instances() / push_instance()
+    /// @note  Edits made through the source set are re-uploaded by the instanced set too, arrays the source replaces
+    /// @note  (copy_*/move_*/release_*) are re-shared. Edits made through the instanced set are not reported back to the source set
+    __INLINE__ void set_new_instanced_primitive_set(const std::string& name, const std::string& source_name);
+
     /// @brief get current primitive set name
     /// @return std::string
     __INLINE__ const std::string get_current_primitive_set_name() const { return currentPrimitiveSetInstanceName; }
@@ -684,6 +942,18 @@ public:
     /// @brief Move a Index array to the current primitive set (replaces the current array)
     __INLINE__ void move_index_array(std::vector<uint32_t>&& index_array);
 
+    /// @brief Overwrite positions in place starting at float element offset (records a dirty range for partial upload)
+    __INLINE__ void update_positions(const size_t& offset, const std::vector<float>& span);
+
+    /// @brief Overwrite normals in place starting at float element offset (records a dirty range for partial upload)
+    __INLINE__ void update_normals(const size_t& offset, const std::vector<float>& span);
+
+    /// @brief Overwrite colors in place starting at byte element offset (records a dirty range for partial upload)
+    __INLINE__ void update_colors(const size_t& offset, const std::vector<uint8_t>& span);
+
+    /// @brief Overwrite indices in place starting at index element offset (records a dirty range for partial upload)
+    __INLINE__ void update_indices(const size_t& offset, const std::vector<uint32_t>& span);
+
     /// @brief    copy by values vertex attrib array
     /// @details  Copy the vertex attrib array by values to another primitive set
     /// @details  This is useful when you want to copy the same vertex attrib array between multiple primitive sets
@@ -0,0 +1,145 @@
+#ifndef GP_GUI_GL_STATE_CACHE_H
+#define GP_GUI_GL_STATE_CACHE_H
+
+#include "gp_gui_renderer_api.h"
+
+namespace gridpro_gui
+{
+    ///////////////////////////////////////////////////////
+    ////////// GL State Cache
+    ///////////////////////////////////////////////////////
+    ///// Shadows the program, VAO, scene uniform block and rasteriser state set by the
+    ///// renderer and drops calls that would not change it. Issued and skipped calls are
+    ///// counted in Renderer::API_CALL_COUNT().
+    ///// All binds of these states in the renderer must go through the cache.
+    ///// invalidate() forgets everything (call when someone else may have touched the state).
+    ///// Usage :
+    ///// GLStateCache::GetInstance().use_program(program);
+    ///////////////////////////////////////////////////////
+    class GLStateCache
+    {
+      public :
+      static GLStateCache& GetInstance()
+      {
+          static GLStateCache instance;
+          return instance;
+      }
+
+      void use_program(const GLuint program)
+      {
+          if(!issue(is_known(PROGRAM) && m_program == program)) return;
+          Renderer::GL_API()->glUseProgram(program);
+          m_program = program;
+          m_known  |= PROGRAM;
+      }
+
+      void bind_vertex_array(const GLuint vao)
+      {
+          if(!issue(is_known(VERTEX_ARRAY) && m_vertex_array == vao)) return;
+          Renderer::GL_API()->glBindVertexArray(vao);
+          m_vertex_array = vao;
+          m_known       |= VERTEX_ARRAY;
+      }
+
+      /// @brief glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer) (the renderer binds a single block, see SceneUniformBuffer)
+      void bind_uniform_buffer_base(const GLuint index, const GLuint buffer)
+      {
+          if(!issue(is_known(UNIFORM_BUFFER) && m_uniform_buffer_index == index && m_uniform_buffer == buffer)) return;
+          Renderer::GL_API()->glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+          m_uniform_buffer_index = index;
+          m_uniform_buffer       = buffer;
+          m_known               |= UNIFORM_BUFFER;
+      }
+
+      /// @brief glPolygonMode(GL_FRONT_AND_BACK, mode)
+      void polygon_mode(const GLenum mode)
+      {
+          if(!issue(is_known(POLYGON_MODE) && m_polygon_mode == mode)) return;
+          Renderer::GL_API()->glPolygonMode(GL_FRONT_AND_BACK, mode);
+          m_polygon_mode = mode;
+          m_known       |= POLYGON_MODE;
+      }
+
+      void polygon_offset_fill(const bool enabled)
+      {
+          if(!issue(is_known(POLYGON_OFFSET_FILL) && m_polygon_offset_fill == enabled)) return;
+          if(enabled) Renderer::GL_API()->glEnable(GL_POLYGON_OFFSET_FILL);
+          else        Renderer::GL_API()->glDisable(GL_POLYGON_OFFSET_FILL);
+          m_polygon_offset_fill = enabled;
+          m_known              |= POLYGON_OFFSET_FILL;
+      }
+
+      void polygon_offset(const GLfloat factor, const GLfloat units)
+      {
+          if(!issue(is_known(POLYGON_OFFSET) && m_offset_factor == factor && m_offset_units == units)) return;
+          Renderer::GL_API()->glPolygonOffset(factor, units);
+          m_offset_factor = factor;
+          m_offset_units  = units;
+          m_known        |= POLYGON_OFFSET;
+      }
+
+      void line_width(const GLfloat width)
+      {
+          if(!issue(is_known(LINE_WIDTH) && m_line_width == width)) return;
+          Renderer::GL_API()->glLineWidth(width);
+          m_line_width = width;
+          m_known     |= LINE_WIDTH;
+      }
+
+      /// @brief Deleting the bound program / VAO / uniform buffer reverts the binding to 0
+      void on_program_deleted(const GLuint program)        { if(m_program == program)         m_known &= ~PROGRAM; }
+      void on_vertex_array_deleted(const GLuint vao)       { if(m_vertex_array == vao)        m_known &= ~VERTEX_ARRAY; }
+      void on_uniform_buffer_deleted(const GLuint buffer)  { if(m_uniform_buffer == buffer)   m_known &= ~UNIFORM_BUFFER; }
+
+      /// @brief Unbind program / VAO and restore the fill rasteriser state (end of a pass)
+      void restore_defaults()
+      {
+          use_program(0);
+          bind_vertex_array(0);
+          polygon_offset_fill(false);
+          polygon_mode(GL_FILL);
+      }
+
+      void invalidate() { m_known = 0; }
+
+      private :
+      GLStateCache() : m_known(0), m_program(0), m_vertex_array(0), m_uniform_buffer_index(0), m_uniform_buffer(0),
+                       m_polygon_mode(GL_FILL), m_polygon_offset_fill(false), m_offset_factor(0.0f), m_offset_units(0.0f),
+                       m_line_width(1.0f) {}
+      GLStateCache(const GLStateCache&) = delete;
+      GLStateCache& operator=(const GLStateCache&) = delete;
+
+      enum TrackedState {
+          PROGRAM             = 1 << 0,
+          VERTEX_ARRAY        = 1 << 1,
+          POLYGON_MODE        = 1 << 2,
+          POLYGON_OFFSET_FILL = 1 << 3,
+          POLYGON_OFFSET      = 1 << 4,
+          LINE_WIDTH          = 1 << 5,
+          UNIFORM_BUFFER      = 1 << 6
+      };
+
+      const bool is_known(const TrackedState state) const { return (m_known & state) != 0; }
+
+      /// @brief Count the call and return true if it has to reach GL
+      const bool issue(const bool redundant)
+      {
+          Renderer& renderer = Renderer::GetInstance();
+          if(redundant) { ++renderer.gl_api_skipped_count; return false; }
+          ++renderer.gl_api_call_count;
+          return true;
+      }
+
+      uint32_t m_known;
+      GLuint   m_program;
+      GLuint   m_vertex_array;
+      GLuint   m_uniform_buffer_index;
+      GLuint   m_uniform_buffer;
+      GLenum   m_polygon_mode;
+      bool     m_polygon_offset_fill;
+      GLfloat  m_offset_factor, m_offset_units;
+      GLfloat  m_line_width;
+    };
+}
+
+#endif // GP_GUI_GL_STATE_CACHE_H
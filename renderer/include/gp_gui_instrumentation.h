@@ -7,6 +7,7 @@
 #include <iostream>
 #include <chrono>
 #include <cstdio>
+#include <cstdint>
 
 
 #include "gp_gui_debug.h"
@@ -142,6 +143,65 @@ namespace Instrumentation {
     }
 
 };
+///////////////////////////////////////////////////////    
+////////// Fence Wait Statistics
+//////////////////////////////////////////////////////
+///// Collected by the streaming uploader for every fence it has to check
+///// before reusing a segment of its staging ring.
+///// Usage :
+///// StreamingUploader::GetInstance().get_fence_statistics().print();
+//////////////////////////////////////////////////////    
+
+    class FenceWaitStatistics {
+
+    public:
+
+         FenceWaitStatistics() { reset(); }
+
+         void reset() {
+             fenceWaits = 0;
+             stalledWaits = 0;
+             orphanedBuffers = 0;
+             bytesStreamed = 0;
+             totalWaitMilliseconds = 0.0;
+             maxWaitMilliseconds = 0.0;
+         }
+
+         // A stalled wait is one where the GPU had not yet released the segment
+         void record_wait(double milliseconds, bool stalled) {
+             ++fenceWaits;
+             if (stalled) ++stalledWaits;
+             totalWaitMilliseconds += milliseconds;
+             if (milliseconds > maxWaitMilliseconds) maxWaitMilliseconds = milliseconds;
+         }
+
+         void record_orphan() { ++orphanedBuffers; }
+         void record_bytes(uint64_t bytes) { bytesStreamed += bytes; }
+
+         uint64_t getFenceWaits() const { return fenceWaits; }
+         uint64_t getStalledWaits() const { return stalledWaits; }
+         uint64_t getOrphanedBuffers() const { return orphanedBuffers; }
+         uint64_t getBytesStreamed() const { return bytesStreamed; }
+         double getTotalWaitMilliseconds() const { return totalWaitMilliseconds; }
+         double getMaxWaitMilliseconds() const { return maxWaitMilliseconds; }
+         double getAverageWaitMilliseconds() const {
+             return fenceWaits ? totalWaitMilliseconds / static_cast<double>(fenceWaits) : 0.0;
+         }
+
+         void print() const {
+             std::cout << "Fence waits: " << fenceWaits << " (stalled " << stalledWaits << ")"
+                       << ", wait total " << totalWaitMilliseconds << "ms, max " << maxWaitMilliseconds << "ms"
+                       << ", orphaned " << orphanedBuffers << ", streamed " << bytesStreamed << " bytes" << std::endl;
+         }
+
+    private:
+    uint64_t fenceWaits;
+    uint64_t stalledWaits;
+    uint64_t orphanedBuffers;
+    uint64_t bytesStreamed;
+    double totalWaitMilliseconds;
+    double maxWaitMilliseconds;
+};
 } // Instrumentation
 } // GridPro_gui
 
@@ -2,6 +2,8 @@
 #define GP_GUI_OPENGL_3_3_RENDER_KERNEL_H
 
 #include <memory>
+#include <cstdint>
+#include <glm/glm.hpp>
 
 namespace gridpro_gui
 {
@@ -9,6 +11,7 @@ namespace gridpro_gui
      class VertexArrayObject;
      class Shader;
      class OpenGLTexture;
+     struct BatchedDrawRecord;
      
      namespace Event
      {
@@ -23,11 +26,27 @@ namespace gridpro_gui
      ~OpenGL_3_3_RenderKernel();
     
       void set_geometry_descriptor(const std::shared_ptr<GeometryDescriptor>& geometry_descriptor);
+      /// @brief Set the geometry descriptor with a VAO already packed by VertexArrayObject::stage() (only the GL upload runs here)
+      /// @brief or already uploaded by VertexArrayObject::upload_staged_batch() (nothing is uploaded)
+      void set_geometry_descriptor(const std::shared_ptr<GeometryDescriptor>& geometry_descriptor, const std::shared_ptr<VertexArrayObject>& staged_vao);
       std::shared_ptr<GeometryDescriptor>& get_descriptor() { return m_geometry_descriptor; }
 
       bool render_display_mode();
       bool render_selection_mode();
 
+      /// @brief Fill the draw record for the batched render path (false if this kernel has to use render_*_mode)
+      bool prepare_batched_draw(const bool selection_mode, BatchedDrawRecord& draw);
+
+      /// @brief Key for sorting the draws of a pass by program / rasteriser state / primitive type
+      const uint64_t get_draw_sort_key(const bool selection_mode) const;
+
+      /// @brief Hash of everything this kernel contributes to the pick image (pending geometry uploads included)
+      const uint64_t get_pick_signature() const;
+
+      /// @brief World matrix of the entity in the scene graph (drawn on top of SceneState::m_model) and its version
+      const glm::mat4& get_world_matrix() const;
+      const uint32_t get_world_version() const;
+
       void set_kernel_id(uint32_t kernel_id) { m_kernel_id = kernel_id; }
       uint32_t get_kernel_id() { return m_kernel_id; }
       
@@ -35,9 +54,16 @@ namespace gridpro_gui
       
       void init();
       void reset();
+      void sync_gpu_buffers();
       void execute_draw_command(const GLenum& primitive_type = GL_NONE_NULL);
+      void set_dequantization_uniforms();
+      void ensure_color_reservation();
       void set_rasteriser_state();
       void reset_rasteriser_state();
+      /// @brief True if the current primitive set is drawn with glDrawElementsInstanced (per instance transforms / colors)
+      const bool is_instanced() const;
+      /// @brief Fill (or wireframe) color of the bound display program, instance colors only apply to the fill
+      void set_display_color(const glm::vec4& color, const bool wireframe_pass);
 
       // Member Variables
       std::shared_ptr<GeometryDescriptor> m_geometry_descriptor;
@@ -46,6 +72,8 @@ namespace gridpro_gui
       std::shared_ptr<OpenGLTexture>      m_texture;
       bool init_flag;
       uint32_t m_kernel_id;
+      /// Pick id range last reserved with the scene (compared with the descriptor on every pick draw)
+      uint32_t m_reserved_color_start, m_reserved_color_count;
     };
 }
 
@@ -0,0 +1,89 @@
+#ifndef GP_GUI_PICK_ID_ALLOCATOR_H
+#define GP_GUI_PICK_ID_ALLOCATOR_H
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+
+namespace gridpro_gui
+{
+    ///////////////////////////////////////////////////////
+    ////////// Pick Id Allocator
+    ///////////////////////////////////////////////////////
+    ///// Hands out contiguous ranges of pick ids above a base id. Released ranges go to a
+    ///// first-fit free-list (start -> count) that is coalesced on release, and ranges at the
+    ///// top are given back to the bump pointer, so the id space stays compact.
+    ///// Usage :
+    ///// uint32_t start = allocator.allocate(count);
+    ///// ----------
+    ///// allocator.release(start, count);
+    ///////////////////////////////////////////////////////
+    class PickIdAllocator
+    {
+      public :
+      explicit PickIdAllocator(const uint32_t base_id) : m_base(base_id), m_next(base_id) {}
+
+      /// @brief Reserve count consecutive ids and return the first one
+      uint32_t allocate(const uint32_t count)
+      {
+          for(std::map<uint32_t, uint32_t>::iterator it = m_free_ranges.begin(); it != m_free_ranges.end(); ++it)
+          {
+              if(it->second < count) continue;
+              const uint32_t start = it->first;
+              const uint32_t left  = it->second - count;
+              m_free_ranges.erase(it);
+              if(left > 0) m_free_ranges[start + count] = left;
+              return start;
+          }
+
+          const uint32_t start = m_next;
+          m_next += count;
+          return start;
+      }
+
+      /// @brief Give the ids [start, start + count) back
+      void release(const uint32_t start, const uint32_t count)
+      {
+          if(count == 0) return;
+          std::map<uint32_t, uint32_t>::iterator it = m_free_ranges.emplace(start, count).first;
+
+          /// Merge with the following and the preceding free range
+          std::map<uint32_t, uint32_t>::iterator next = std::next(it);
+          if(next != m_free_ranges.end() && it->first + it->second == next->first)
+          {
+              it->second += next->second;
+              m_free_ranges.erase(next);
+          }
+          if(it != m_free_ranges.begin())
+          {
+              std::map<uint32_t, uint32_t>::iterator prev = std::prev(it);
+              if(prev->first + prev->second == it->first)
+              {
+                  prev->second += it->second;
+                  m_free_ranges.erase(it);
+                  it = prev;
+              }
+          }
+
+          /// A free range at the top returns to the bump pointer
+          if(it->first + it->second == m_next)
+          {
+              m_next = it->first;
+              m_free_ranges.erase(it);
+          }
+      }
+
+      void reset() { m_free_ranges.clear(); m_next = m_base; }
+
+      /// @brief One past the highest id in use
+      const uint32_t get_end() const { return m_next; }
+      const uint32_t get_base() const { return m_base; }
+      const size_t get_num_free_ranges() const { return m_free_ranges.size(); }
+
+      private :
+      uint32_t m_base, m_next;
+      std::map<uint32_t, uint32_t> m_free_ranges;
+    };
+}
+
+#endif // GP_GUI_PICK_ID_ALLOCATOR_H
@@ -0,0 +1,169 @@
+#ifndef GP_GUI_RAY_PICK_ENGINE_H
+#define GP_GUI_RAY_PICK_ENGINE_H
+
+#include "gp_gui_forward_structs.h"
+#include "gp_gui_geometry_descriptor.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gridpro_gui
+{
+    /// @brief Ray in the object space of SceneState::m_model (direction is normalised, distances are in object units)
+    struct PickRay
+    {
+        glm::vec3 origin;
+        glm::vec3 direction;
+    };
+
+    /// @brief Six planes (normal, offset) with the inside where dot(normal, p) + offset >= 0 (normals have unit length)
+    struct PickFrustum
+    {
+        glm::vec4 planes[6];
+    };
+
+    /// @brief Nearest ray hit : entity / sub entity as the GPU pick reports them and the distance along the ray
+    struct RayPickHit
+    {
+        uint32_t entity_id;
+        uint32_t sub_entity_id;
+        float    distance;
+    };
+
+    ///////////////////////////////////////////////////////
+    ////////// Primitive BVH
+    ///////////////////////////////////////////////////////
+    ///// Bounding volume hierarchy over the pickable elements of one PrimitiveSetInstance.
+    ///// Triangles (strips / fans / polygons included) are hit exactly, quads are split in two
+    ///// triangles, lines are hit within line_tolerance and points within point_radius.
+    ///// Sub entity ids follow the pick scheme like the GPU pick : primitive index (PICK_BY_PRIMITIVE),
+    ///// vertex index (PICK_BY_VERTEX, every vertex is a point) or 0 (PICK_GEOMETRY).
+    ///// No GL call is made, so it works without a context.
+    ///// Usage :
+    ///// PrimitiveBVH bvh;
+    ///// bvh.build(*primitive_set, 0.01f, 0.01f);
+    ///// float distance; uint32_t sub_entity_id;
+    ///// if(bvh.intersect(ray, distance, sub_entity_id)) { ... }
+    ///////////////////////////////////////////////////////
+    class PrimitiveBVH
+    {
+      public :
+      PrimitiveBVH() : m_bounds_min(0.0f), m_bounds_max(0.0f) {}
+
+      /// @brief (Re)build from the positions / indices of the primitive set (PICK_NONE builds an empty hierarchy)
+      void build(const GeometryDescriptor::PrimitiveSetInstance& primitive_set, const float line_tolerance, const float point_radius);
+
+      /// @brief Nearest element hit closer than distance (distance and sub_entity_id are updated on a hit)
+      const bool intersect(const PickRay& ray, float& distance, uint32_t& sub_entity_id) const;
+
+      /// @brief Append the sub entity ids of the elements overlapping the frustum (conservative near the frustum edges)
+      void overlap(const PickFrustum& frustum, std::vector<uint32_t>& sub_entity_ids) const;
+
+      const bool empty() const { return m_nodes.empty(); }
+      const size_t element_count() const { return m_elements.size(); }
+      const glm::vec3& bounds_min() const { return m_bounds_min; }
+      const glm::vec3& bounds_max() const { return m_bounds_max; }
+
+      private :
+      enum ElementKind : uint8_t { TRIANGLE, SEGMENT, POINT };
+
+      /// One triangle, segment (v[0], v[1]) or point (v[0]) with the half width used for lines / points and its bounds
+      struct Element
+      {
+          glm::vec3   v[3];
+          glm::vec3   min, max;
+          float       radius;
+          uint32_t    sub_entity_id;
+          ElementKind kind;
+      };
+
+      /// Leaves hold elements [first, first + count), inner nodes have count 0 and their children at index + 1 and right
+      struct Node
+      {
+          glm::vec3 min, max;
+          uint32_t  first, count, right;
+      };
+
+      void add_triangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const uint32_t sub_entity_id);
+      void add_segment(const glm::vec3& a, const glm::vec3& b, const uint32_t sub_entity_id, const float radius);
+      void add_point(const glm::vec3& a, const uint32_t sub_entity_id, const float radius);
+      uint32_t build_node(const uint32_t first, const uint32_t count);
+      const bool intersect_element(const Element& element, const PickRay& ray, float& distance) const;
+
+      std::vector<Element> m_elements;
+      std::vector<Node>    m_nodes;
+      glm::vec3 m_bounds_min, m_bounds_max;
+    };
+
+    ///////////////////////////////////////////////////////
+    ////////// Ray Pick Engine
+    ///////////////////////////////////////////////////////
+    ///// CPU pick engine answering ray and frustum queries from the scene matrices without
+    ///// rendering or reading back the selection buffer. One PrimitiveBVH is built per entity
+    ///// (its current primitive set, the one the render kernel draws, in the entity's space,
+    ///// queries are moved there with the scene graph world matrix),
+    ///// the builds run in parallel across entities. Instanced primitive sets share one hierarchy
+    ///// between their instances and report instance * stride + element like the GPU pick.
+    ///// Works headless, e.g. in batch tools :
+    ///// Usage :
+    ///// RayPickEngine engine;
+    ///// engine.build({ {1, descriptor_a}, {2, descriptor_b} });    // or engine.build(scene.ray_pick_sources())
+    ///// RayPickHit hit;
+    ///// if(engine.ray_pick(RayPickEngine::ray_from_cursor(scene_state, x, y, viewport), hit)) { ... }
+    ///// std::vector<PickSelection> boxed = engine.frustum_pick(RayPickEngine::frustum_from_rectangle(scene_state, x0, y0, x1, y1, viewport));
+    ///////////////////////////////////////////////////////
+    class RayPickEngine
+    {
+      public :
+      /// One entity : the id reported by the picks, its geometry and its scene graph world matrix
+      struct Source
+      {
+          uint32_t entity_id;
+          std::shared_ptr<GeometryDescriptor> descriptor;
+          glm::mat4 world = glm::mat4(1.0f);
+      };
+
+      RayPickEngine() : m_line_tolerance(GL_RAY_PICK_LINE_TOLERANCE), m_point_radius(GL_RAY_PICK_POINT_RADIUS) {}
+
+      /// @brief Hit distance of lines / radius of points in object units (used by the next build)
+      void set_tolerance(const float line_tolerance, const float point_radius) { m_line_tolerance = line_tolerance; m_point_radius = point_radius; }
+
+      /// @brief Rebuild the hierarchies of all sources on num_threads workers (0 = one per hardware thread)
+      /// @note  the descriptors must not be modified during the build
+      void build(const std::vector<Source>& sources, const size_t num_threads = 0);
+      void clear() { m_entities.clear(); }
+      const size_t size() const { return m_entities.size(); }
+
+      /// @brief Nearest hit along the ray
+      const bool ray_pick(const PickRay& ray, RayPickHit& hit) const;
+      /// @brief Every entity / sub entity overlapping the frustum (sorted by entity, then sub entity)
+      std::vector<PickSelection> frustum_pick(const PickFrustum& frustum) const;
+
+      /// @brief Ray through a cursor position (window coordinates, y down) of viewport (x, y, width, height)
+      static PickRay ray_from_cursor(const SceneState& scene_state, const float x, const float y, const glm::vec4& viewport);
+      /// @brief Frustum of the rectangle spanned by two cursor positions
+      static PickFrustum frustum_from_rectangle(const SceneState& scene_state, const float x0, const float y0, const float x1, const float y1, const glm::vec4& viewport);
+
+      private :
+      /// One placement of the hierarchy : the entity world matrix, times the instance transform for instanced sets
+      struct Placement
+      {
+          bool      transformed;
+          glm::mat4 world, inverse_world;
+      };
+
+      /// Queries are moved into the space of each placement (line tolerance / point radius are in entity units)
+      struct EntityBVH
+      {
+          uint32_t     entity_id;
+          PrimitiveBVH bvh;
+          std::vector<Placement> placements;   /// One per instance (a single one when not instanced)
+          uint32_t     instance_stride;        /// Sub entity ids per instance
+      };
+
+      std::vector<EntityBVH> m_entities;
+      float m_line_tolerance, m_point_radius;
+    };
+}
+
+#endif // GP_GUI_RAY_PICK_ENGINE_H
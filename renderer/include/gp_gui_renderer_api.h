@@ -24,6 +24,13 @@ class Renderer {
 public :
 
 uint64_t gl_api_call_count; 
+uint64_t gl_api_skipped_count;
+
+/// @brief GL calls issued and skipped as redundant by the GLStateCache (issued also counts the Legacy / COMPAT / CORE wrappers)
+struct APICallCount {
+    uint64_t issued;
+    uint64_t skipped;
+};
 
 static Renderer& GetInstance() {
     static Renderer instance;
@@ -112,7 +119,18 @@ QOpenGLContext* context;
 QOpenGLFunctions* glFunctions;
 QOpenGLWidget* gl_widget;
 
-uint64_t API_CALL_COUNT() { return this->gl_api_call_count; }
+static APICallCount API_CALL_COUNT() 
+{ 
+    Renderer& OpenGL_Functions_Singleton_Access = GetInstance();
+    return { OpenGL_Functions_Singleton_Access.gl_api_call_count, OpenGL_Functions_Singleton_Access.gl_api_skipped_count }; 
+}
+
+static void RESET_API_CALL_COUNT()
+{
+    Renderer& OpenGL_Functions_Singleton_Access = GetInstance();
+    OpenGL_Functions_Singleton_Access.gl_api_call_count    = 0;
+    OpenGL_Functions_Singleton_Access.gl_api_skipped_count = 0;
+}
 
 void initialise()
 {
@@ -128,6 +146,7 @@ void initialise()
 private :
 Renderer() { 
     gl_api_call_count = 0;
+    gl_api_skipped_count = 0;
     //initialise();
     context = QOpenGLContext::currentContext();
     if (context) {
@@ -4,6 +4,8 @@
 #include "gp_gui_renderer_api.h"
 #include "gp_gui_scene.h"
 #include "gp_gui_entity_handle.h"
+#include "gp_gui_batched_render_path.h"
+#include "gp_gui_selection_scheduler.h"
 #include "ecs.h"
 
 namespace gridpro_gui
@@ -12,6 +14,16 @@ namespace gridpro_gui
    {
      public :
      void update(float layer) override;
+
+     /// @brief Decides when the offscreen pick pass is re-rendered (see SelectionPassScheduler)
+     SelectionPassScheduler& get_selection_scheduler() { return m_selection_scheduler; }
+
+     private :
+     /// @brief Draw every pickable entity once into the current pick target (once per layer when depth peeling)
+     void render_pick_layer();
+
+     BatchedRenderPath m_batched_path;
+     SelectionPassScheduler m_selection_scheduler;
    };
 }
 
@@ -4,8 +4,15 @@
 #include "ecs.h"
 #include <unordered_map>
 #include <deque>
+#include <vector>
+#include <memory>
 #include "gp_gui_forward_structs.h"
 #include "gp_gui_communications.h"
+#include "gp_gui_pick_id_allocator.h"
+#include "gp_gui_slot_map.h"
+#include "gp_gui_entity_key_table.h"
+#include "gp_gui_scene_graph.h"
+#include "gp_gui_ray_pick_engine.h"
 
 namespace gridpro_gui
 {
@@ -20,6 +27,12 @@ namespace gridpro_gui
     {
         class Publisher;
     }
+
+    class GeometryDescriptor;
+    class GeometryCommitPipeline;
+
+    /// @brief Entity key and the geometry to commit for it (commit_batch)
+    typedef std::pair<std::string, std::shared_ptr<GeometryDescriptor>> EntityCommit;
     
     class Gp_gui_scene
     {
@@ -30,17 +43,54 @@ namespace gridpro_gui
          // The Only Functions you'll ever need ------------------------+
          /// Adds an entity to the scene
          Gp_gui_entity_handle get_entity(const std::string& entity_key);
+         Gp_gui_entity_handle get_entity(const EntityKey entity_key);
          /// Updates all Systems
          void update(const float& layer);
          ///------------------------------------------------------------+
 
+         /// Creates / updates the entities of count (key, descriptor) pairs at once (GL thread) : registries are reserved up front,
+         /// every descriptor is validated before any GL call and the uploads share one buffer arena allocation per pool
+         std::vector<Gp_gui_entity_handle> commit_batch(const EntityCommit* commits, const size_t count);
+         std::vector<Gp_gui_entity_handle> commit_batch(const std::vector<EntityCommit>& commits);
+
+         /// Validates and packs the descriptor on the worker pool, the entity is created by a later update()
+         void commit_async(const std::string& entity_key, const std::shared_ptr<GeometryDescriptor>& descriptor);
+         /// Number of asynchronous commits not yet in the scene
+         size_t pending_commits() const;
+         /// Time spent on GL uploads of asynchronous commits per update (GL_COMMIT_BUDGET_MS by default)
+         void set_commit_budget(const double& budget_ms) { m_commit_budget_ms = budget_ms; }
+
          void update_mouse_event(const float& x, const float& y);
 
+         /// Reassign every reservation from scratch in entity order (compaction, not needed per frame)
          void update_color_reservations();
+         /// (Re)reserve the pick ids of one entity if its pick scheme / primitive count changed (O(log n))
+         void reserve_color_ids(const uint32_t entity_id, GeometryDescriptor& descriptor);
          uint32_t get_actual_id(const uint32_t& color_id);
+         /// Reservation containing the color id (binary search of the interval table, nullptr if none)
+         const unique_color_reservation* find_color_reservation(const uint32_t& color_id) const;
+
+         /// Entities / sub entities visible in the rectangle spanned by two cursor positions (box selection)
+         std::vector<PickSelection> select_rectangle(const float& x0, const float& y0, const float& x1, const float& y1);
+         /// Entities / sub entities visible inside a lasso of cursor positions
+         std::vector<PickSelection> select_lasso(const std::vector<glm::vec2>& lasso);
+         /// Select through : entities / sub entities under the cursor front to back (needs framebuffer::set_depth_peel_layers > 1)
+         std::vector<PickSelection> select_through(const float& x, const float& y);
+         /// Select through a rectangle : every peeled entity / sub entity ordered by its nearest depth
+         std::vector<PickSelection> select_through_rectangle(const float& x0, const float& y0, const float& x1, const float& y1);
+         /// Entity ids and descriptors to build a RayPickEngine from (CPU picking without the pick pass)
+         std::vector<RayPickEngine::Source> ray_pick_sources();
+         /// World space positions / normals of every pixel of a rectangle of the pick image (snapping tools)
+         std::vector<framebuffer::SurfaceSample> unproject_rectangle(const float& x0, const float& y0, const float& x1, const float& y1, uint32_t& width, uint32_t& height);
+         /// inverse(projection * view) of the current scene state (the pick image may be older, see framebuffer::image_inverse_view_projection)
+         const glm::mat4& get_inverse_view_projection();
 
          bool has_entity(const std::string& entity_key);
+         bool has_entity(const EntityKey entity_key);
          bool remove_entity_from_registry(const std::string& entity_key);
+         bool remove_entity_from_registry(const EntityKey entity_key);
+         /// Interned key of an entity id (EntityKeyTable::str gives the string)
+         EntityKey get_entity_key(const uint32_t entity_id) const;
          
          const SceneState::RenderMode get_render_mode() const;
          SceneState& get_scene_state();
@@ -52,19 +102,42 @@ namespace gridpro_gui
          void set_mvp(const glm::mat4& projection, const glm::mat4& view, const glm::mat4& model);
          
      public :
-     std::deque<ecs::Entity> Entity_DataBase;
-     std::unordered_map<std::string, uint32_t> SceneEntityRegistry;
-     std::unordered_map<uint32_t, std::string> EntityIdxKeyMapRegistry;
+     /// Entities stored densely and addressed by generational slots (swap and pop removal)
+     SlotMap<ecs::Entity> Entity_DataBase;
+     /// Parent / child transforms of the entities (TransformComponent), world matrices are resolved lazily per draw
+     SceneGraph Transforms;
+     /// Key -> slot and slot -> key, the slot is the entity id of the render kernel and of the pick events
+     /// Keys are interned symbols (EntityKeyTable), strings only appear at the API boundary
+     std::unordered_map<EntityKey, uint32_t> SceneEntityRegistry;
+     std::unordered_map<uint32_t, EntityKey> EntityIdxKeyMapRegistry;
      std::unordered_map<uint32_t, unique_color_reservation> unique_colr_reservations;
+     /// The same reservations as a contiguous table sorted by _Min_ColorID_ (for O(log n) color id lookups)
+     std::vector<unique_color_reservation> color_reservation_table;
      ecs::EntityManager RenderableEntitiesManager;
      ecs::SystemManager RenderSystemsManager;
 
      uint32_t last_color_id;    
+     /// Free-list of the pick id space (ids start at GL_PICK_ID_BASE)
+     PickIdAllocator color_id_allocator;
      
      Event::Publisher*  PublisherInstance;
 
+     /// Created by the first commit_async() (null until then)
+     std::unique_ptr<GeometryCommitPipeline> CommitPipeline;
+
      private:
+     /// Removed reservations are left in color_reservation_table as tombstones (empty interval) instead of shifting the table,
+     /// they are dropped before the next insertion so a tombstone never shadows a live interval
+     void retire_color_reservation(const uint32_t entity_id);
+     void drop_color_reservation_tombstones();
+     size_t color_reservation_tombstones;
+
+     /// Entity / sub entity of color ids in their order (ids without a reservation are dropped)
+     std::vector<PickSelection> resolve_color_ids(const std::vector<uint32_t>& ids) const;
+
      mutable SceneState m_scene_state_obj;
+     glm::mat4 m_view_projection, m_inverse_view_projection;
+     double m_commit_budget_ms;
      
     };
 
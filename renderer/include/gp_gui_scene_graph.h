@@ -0,0 +1,80 @@
+#ifndef GP_GUI_SCENE_GRAPH_H
+#define GP_GUI_SCENE_GRAPH_H
+
+#include "ecs.h"
+#include "gp_gui_slot_map.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace gridpro_gui
+{
+    /// @brief Scene graph node of an entity : transform relative to the parent and the cached world matrix
+    /// @note  Modify it through SceneGraph (or the entity handle), direct writes skip the dirty propagation
+    struct TransformComponent
+    {
+        static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+        TransformComponent() : local(1.0f), world(1.0f), parent(NO_PARENT), world_dirty(true), world_version(0) {}
+
+        glm::mat4 local;
+        glm::mat4 world;
+        uint32_t  parent;                  /// Entity id of the parent, NO_PARENT for roots
+        std::vector<uint32_t> children;    /// Entity ids of the children
+        bool      world_dirty;             /// Set for the whole subtree of a changed node
+        uint32_t  world_version;           /// Incremented whenever world is recomputed
+    };
+
+    ///////////////////////////////////////////////////////
+    ////////// Scene Graph
+    ///////////////////////////////////////////////////////
+    ///// Parent / child transforms over the entities of a Gp_gui_scene. Each entity with a
+    ///// TransformComponent is drawn with its world matrix (parent world * local) on top of
+    ///// SceneState::m_model (placing assemblies and their parts).
+    ///// Every entity needs a descriptor of its own : the render kernels keep the GPU buffers,
+    ///// the dirty state and the pick id range per descriptor. For many copies of one geometry
+    ///// (periodic / rotational copies of a passage) use an instanced primitive set instead
+    ///// (GeometryDescriptor::set_new_instanced_primitive_set), under one entity.
+    ///// Changing a node only marks its subtree dirty, the world matrices are recomputed on
+    ///// demand when an entity is drawn or picked. Entities without the component use identity.
+    ///// Usage :
+    ///// scene.Transforms.set_local_transform(copy_id, glm::rotate(glm::mat4(1.0f), angle, axis));
+    ///// scene.Transforms.set_parent(copy_id, assembly_id);
+    ///// ----------
+    ///// const glm::mat4& world = scene.Transforms.get_world_matrix(copy_id);
+    ///////////////////////////////////////////////////////
+    class SceneGraph
+    {
+      public :
+      explicit SceneGraph(SlotMap<ecs::Entity>& entities) : m_entities(entities) {}
+
+      /// @brief Transform relative to the parent (the component is added on first use)
+      void set_local_transform(const uint32_t entity_id, const glm::mat4& local);
+      const glm::mat4& get_local_transform(const uint32_t entity_id);
+
+      /// @brief Attach to a new parent (NO_PARENT detaches). Throws if it would create a cycle
+      void set_parent(const uint32_t entity_id, const uint32_t parent_id);
+      const uint32_t get_parent(const uint32_t entity_id);
+
+      /// @brief Cached world matrix, the dirty ancestors are recomputed first (identity without a TransformComponent)
+      const glm::mat4& get_world_matrix(const uint32_t entity_id);
+      /// @brief Changes whenever the world matrix changes (0 without a TransformComponent)
+      const uint32_t get_world_version(const uint32_t entity_id);
+
+      /// @brief Unlink an entity before it is destroyed, its children become roots (keeping their local transform)
+      void remove(const uint32_t entity_id);
+
+      private :
+      /// @brief Component of a live entity, nullptr if it has none
+      TransformComponent* find(const uint32_t entity_id);
+      /// @brief Component of a live entity, added if missing (throws for unknown ids)
+      TransformComponent& node(const uint32_t entity_id);
+      /// @brief Mark the node and its subtree dirty (stops at nodes already dirty, their subtree is dirty too)
+      void mark_dirty(const uint32_t entity_id);
+
+      SlotMap<ecs::Entity>& m_entities;
+      std::vector<uint32_t> m_stack;
+    };
+}
+
+#endif // GP_GUI_SCENE_GRAPH_H
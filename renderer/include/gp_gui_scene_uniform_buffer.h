@@ -0,0 +1,61 @@
+#ifndef GP_GUI_SCENE_UNIFORM_BUFFER_H
+#define GP_GUI_SCENE_UNIFORM_BUFFER_H
+
+#include "gp_gui_renderer_api.h"
+#include "gp_gui_forward_structs.h"
+
+namespace gridpro_gui
+{
+    /// @brief std140 image of the SceneBlock uniform block (vec3 members are padded to vec4)
+    struct SceneUniformData
+    {
+        glm::mat4 projection;
+        glm::mat4 view;
+        glm::mat4 model;
+        glm::vec4 light_position;
+        glm::vec4 light_ambient;
+        glm::vec4 light_diffuse;
+        glm::vec4 light_specular;
+    };
+    static_assert(sizeof(SceneUniformData) == 256, "SceneUniformData must match the std140 layout of SceneBlock");
+
+    ///////////////////////////////////////////////////////
+    ////////// Scene Uniform Buffer
+    ///////////////////////////////////////////////////////
+    ///// Holds the scene wide matrices and light of the SceneState in one uniform buffer
+    ///// bound at GL_SCENE_UNIFORM_BLOCK_BINDING. Every shader in gp_gui_shader_src.h reads
+    ///// projection / view / model from the SceneBlock, so they are uploaded once per frame
+    ///// instead of once per draw.
+    ///// Usage :
+    ///// SceneUniformBuffer::GetInstance().update(scene_state);   // before the draws (repeated calls only compare the state)
+    ///////////////////////////////////////////////////////
+    class SceneUniformBuffer
+    {
+      public :
+      static SceneUniformBuffer& GetInstance()
+      {
+          static SceneUniformBuffer instance;
+          return instance;
+      }
+
+      /// @brief Upload the scene state (skipped if it did not change) and bind the block
+      void update(const SceneState& scene_state);
+
+      /// @brief Delete the uniform buffer (call with the context current)
+      void release();
+
+      GLuint get_buffer() const { return m_ubo; }
+
+      private :
+      SceneUniformBuffer() : m_ubo(0), m_uploaded(false) {}
+     ~SceneUniformBuffer() = default;
+      SceneUniformBuffer(const SceneUniformBuffer&) = delete;
+      SceneUniformBuffer& operator=(const SceneUniformBuffer&) = delete;
+
+      GLuint           m_ubo;
+      SceneUniformData m_data;
+      bool             m_uploaded;
+    };
+}
+
+#endif // GP_GUI_SCENE_UNIFORM_BUFFER_H
@@ -0,0 +1,77 @@
+#ifndef GP_GUI_SELECTION_SCHEDULER_H
+#define GP_GUI_SELECTION_SCHEDULER_H
+
+#include "gp_gui_forward_structs.h"
+#include <cstdint>
+#include <cstring>
+
+namespace gridpro_gui
+{
+    ///////////////////////////////////////////////////////
+    ////////// Selection Pass Scheduler
+    ///////////////////////////////////////////////////////
+    ///// Decides if the pick pass has to be rendered this frame. The inputs of the pick image
+    ///// (scene MVP, pick region / viewport, and a signature per render kernel covering its
+    ///// pick scheme, primitive type, id range and pending geometry uploads) are folded into one
+    ///// hash. While the hash is unchanged the cached id image keeps answering picks.
+    ///// Usage :
+    ///// scheduler.begin(scene_state, frame_buffer->pick_pass_signature());
+    ///// for(kernel : kernels) scheduler.accumulate(kernel.get_pick_signature());
+    ///// if(scheduler.end()) { render the pick pass }
+    ///////////////////////////////////////////////////////
+    class SelectionPassScheduler
+    {
+      public :
+      SelectionPassScheduler() : m_enabled(true), m_forced(true), m_hash(0), m_last_hash(0), m_rendered(0), m_skipped(0) {}
+
+      /// @brief Start the signature of this frame
+      void begin(const SceneState& scene_state, const uint64_t pick_pass_signature)
+      {
+          m_hash = FNV_OFFSET;
+          combine(&scene_state.m_projection, sizeof(glm::mat4));
+          combine(&scene_state.m_view,       sizeof(glm::mat4));
+          combine(&scene_state.m_model,      sizeof(glm::mat4));
+          accumulate(pick_pass_signature);
+      }
+
+      /// @brief Add one render kernel (order matters, so added / removed entities change the hash)
+      void accumulate(const uint64_t signature) { combine(&signature, sizeof(uint64_t)); }
+
+      /// @brief True if the pick pass has to be rendered (the hash changed, a pass was requested or scheduling is off)
+      const bool end()
+      {
+          const bool render = !m_enabled || m_forced || m_hash != m_last_hash;
+          m_last_hash = m_hash;
+          m_forced    = false;
+          if(render) ++m_rendered; else ++m_skipped;
+          return render;
+      }
+
+      /// @brief Render the pick pass on the next frame regardless of the hash (state the signatures do not cover)
+      void request_pick_pass() { m_forced = true; }
+
+      void set_enabled(const bool enabled) { m_enabled = enabled; m_forced = true; }
+      const bool is_enabled() const { return m_enabled; }
+
+      /// @brief Frames with / without a pick pass
+      const uint64_t get_rendered_passes() const { return m_rendered; }
+      const uint64_t get_skipped_passes()  const { return m_skipped; }
+
+      private :
+      static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+      static const uint64_t FNV_PRIME  = 1099511628211ull;
+
+      void combine(const void* data, const size_t size)
+      {
+          const uint8_t* bytes = static_cast<const uint8_t*>(data);
+          for(size_t i = 0; i < size; ++i)
+              m_hash = (m_hash ^ bytes[i]) * FNV_PRIME;
+      }
+
+      bool     m_enabled, m_forced;
+      uint64_t m_hash, m_last_hash;
+      uint64_t m_rendered, m_skipped;
+    };
+}
+
+#endif // GP_GUI_SELECTION_SCHEDULER_H
@@ -14,6 +14,35 @@
 namespace gridpro_gui
 {
 
+/// @brief FNV-1a hash of a uniform name (constexpr, so literal names are hashed at compile time)
+constexpr uint32_t uniform_name_hash(const char* name, const uint32_t hash = 2166136261u)
+{
+	return (*name == '\0') ? hash : uniform_name_hash(name + 1, (hash ^ static_cast<uint8_t>(*name)) * 16777619u);
+}
+
+/// @brief A uniform name with its precomputed hash
+/// @note  Usage : static constexpr UniformName OBJECT_COLOR("object_color"); shader->SetVec4fv(OBJECT_COLOR, color);
+/// @note  Build it from a string literal, the shader caches the name pointer
+struct UniformName
+{
+	template<size_t N>
+	explicit constexpr UniformName(const char (&uniform_name)[N]) : name(uniform_name), hash(uniform_name_hash(uniform_name)) {}
+
+	const char* name;
+	uint32_t    hash;
+};
+
+/// @brief Uniform location resolved once after link, typed by the value it accepts
+/// @note  A handle is only valid for the program it was resolved from
+template<typename T>
+struct UniformHandle
+{
+	GLint location = -1;
+	GLint program  = 0;
+
+	const bool is_valid() const { return location != -1; }
+};
+
 class Shader
 {
 public:
@@ -50,6 +79,34 @@ public:
         __INLINE__ void SetMat3fv(const std::string& uniform_name, const glm::mat3& value);
 	__INLINE__ void SetMat4fv(const std::string& uniform_name, const glm::mat4& value);
 
+    /// @brief	Set uniforms by precomputed name hash (no std::string is built)
+	__INLINE__ void Set1i(const UniformName& uniform_name, const int& value);
+	__INLINE__ void Set1ui(const UniformName& uniform_name, const uint32_t& value);
+	__INLINE__ void Set1f(const UniformName& uniform_name, const float& value);
+	__INLINE__ void SetVec3fv(const UniformName& uniform_name, const glm::vec3& value);
+	__INLINE__ void SetVec4fv(const UniformName& uniform_name, const glm::vec4& value);
+	__INLINE__ void SetMat4fv(const UniformName& uniform_name, const glm::mat4& value);
+
+	/// @brief	Resolve a uniform into a typed handle (invalid handle if the program has no such uniform, Set() on it is a no-op)
+	template<typename T>
+	UniformHandle<T> get_uniform_handle(const std::string& uniform_name) const
+	{
+		UniformHandle<T> handle;
+		handle.location = Renderer::GL_API()->glGetUniformLocation(m_program, uniform_name.c_str());
+		handle.program  = m_program;
+		if(!handle.is_valid()) std::cout << "Failed to get uniform location for: " << uniform_name << "\n";
+		return handle;
+	}
+
+    /// @brief	Set uniforms through resolved handles (no lookup at all)
+	__INLINE__ void Set(const UniformHandle<int>& handle, const int& value);
+	__INLINE__ void Set(const UniformHandle<float>& handle, const float& value);
+	__INLINE__ void Set(const UniformHandle<glm::vec2>& handle, const glm::vec2& value);
+	__INLINE__ void Set(const UniformHandle<glm::vec3>& handle, const glm::vec3& value);
+	__INLINE__ void Set(const UniformHandle<glm::vec4>& handle, const glm::vec4& value);
+	__INLINE__ void Set(const UniformHandle<glm::mat3>& handle, const glm::mat3& value);
+	__INLINE__ void Set(const UniformHandle<glm::mat4>& handle, const glm::mat4& value);
+
 	/// @brief	deletes and unlinks a GLSL-Shader-Program
 	/// @note	equivalent to glUseProgram(m_program);            
         __INLINE__ void delete_shader();
@@ -64,6 +121,7 @@ public:
 	/// @return	location if succeeded, otherwhise 0
 
         __INLINE__ GLint GetUniformLocation(const std::string& uniform_name) const;
+        __INLINE__ GLint GetUniformLocation(const UniformName& uniform_name) const;
 
 	/// @brief	Gets the give uniform location
 	/// @param	type	std::string
@@ -91,6 +149,13 @@ private:
 	GLint m_program;
         GLint vs, fs;
 	mutable std::unordered_map<std::string, int> uniformLocations;
+	/// @brief	Location cache of the hashed names, the name is kept to tell colliding hashes apart
+	struct HashedUniformLocation
+	{
+		const char* name;     ///< The UniformName literal (static storage)
+		GLint       location;
+	};
+	mutable std::unordered_map<uint32_t, HashedUniformLocation> hashedUniformLocations;
 	mutable std::unordered_map<std::string, int> vertexAttribLocations;
 	std::string m_vertexShader , m_fragmentShader;
 };
@@ -13,13 +13,27 @@ static const char* BasicVertexShaderSource = R"(
 
     layout(location = 0) in vec3 VertexPos;
 
-    uniform mat4 projection;
-    uniform mat4 model; 
-    uniform mat4 view; 
+    layout(std140, binding = 1) uniform SceneBlock
+    {
+        mat4 projection;
+        mat4 view;
+        mat4 model;
+        vec4 light_position;
+        vec4 light_ambient;
+        vec4 light_diffuse;
+        vec4 light_specular;
+    };
+
+    // Dequantization of 16 bit positions (offset = 0 , scale = 1 for float positions)
+    uniform vec3 position_offset;
+    uniform vec3 position_scale;
+
+    // World matrix of the entity in the scene graph (identity for entities without a transform)
+    uniform mat4 entity_world;
 
     void main()
     {    
-       gl_Position = projection * view * model * vec4(VertexPos, 1.0); 
+       gl_Position = projection * view * model * entity_world * vec4(position_offset + VertexPos * position_scale, 1.0); 
     }
 )";
 
@@ -58,13 +72,24 @@ static const char* SelectPrimitiveVertexShaderSource = R"(
 
     layout(location = 0) in vec3 VertexPos;
 
-    uniform mat4 projection;
-    uniform mat4 model; 
-    uniform mat4 view; 
+    layout(std140, binding = 1) uniform SceneBlock
+    {
+        mat4 projection;
+        mat4 view;
+        mat4 model;
+        vec4 light_position;
+        vec4 light_ambient;
+        vec4 light_diffuse;
+        vec4 light_specular;
+    };
+
+    uniform vec3 position_offset;
+    uniform vec3 position_scale;
+    uniform mat4 entity_world;
     
     void main()
     {            
-      gl_Position = projection * view * model * vec4(VertexPos, 1.0);
+      gl_Position = projection * view * model * entity_world * vec4(position_offset + VertexPos * position_scale, 1.0);
     }
 )";
 
@@ -98,13 +123,24 @@ static const char* SelectGeometryVertexShaderSource = R"(
 
     layout(location = 0) in vec3 VertexPos;
 
-    uniform mat4 projection;
-    uniform mat4 model; 
-    uniform mat4 view; 
+    layout(std140, binding = 1) uniform SceneBlock
+    {
+        mat4 projection;
+        mat4 view;
+        mat4 model;
+        vec4 light_position;
+        vec4 light_ambient;
+        vec4 light_diffuse;
+        vec4 light_specular;
+    };
+
+    uniform vec3 position_offset;
+    uniform vec3 position_scale;
+    uniform mat4 entity_world;
     
     void main()
     {            
-      gl_Position = projection * view * model * vec4(VertexPos, 1.0);
+      gl_Position = projection * view * model * entity_world * vec4(position_offset + VertexPos * position_scale, 1.0);
     }
 )";
 
@@ -122,6 +158,354 @@ static const char* SelectGeometryFragmentShaderSource = R"(
     }
 )";
 
+// Batched shaders : per draw data is read from the SSBO at binding 0 (GL_BATCH_DRAW_DATA_BINDING)
+// indexed by the draw id attribute (location 3, divisor 1, selected with baseInstance)
+
+static const char* BatchedBasicVertexShaderSource = R"(
+
+    #version 430 core
+
+    layout(location = 0) in vec3 VertexPos;
+    layout(location = 3) in uint DrawID;
+
+    struct DrawData
+    {
+        vec4 color;
+        vec4 wireframe_color;
+        vec4 position_offset;
+        vec4 position_scale;
+        uint pick_id_base;
+        mat4 world;
+    };
+
+    layout(std430, binding = 0) readonly buffer DrawDataBuffer
+    {
+        DrawData draws[];
+    };
+
+    layout(std140, binding = 1) uniform SceneBlock
+    {
+        mat4 projection;
+        mat4 view;
+        mat4 model;
+        vec4 light_position;
+        vec4 light_ambient;
+        vec4 light_diffuse;
+        vec4 light_specular;
+    };
+
+    // 0 : fill pass with the object color, 1 : wireframe color
+    uniform int wireframe_pass;
+
+    flat out vec4 object_color;
+
+    void main()
+    {    
+       DrawData draw = draws[DrawID];
+       object_color = (wireframe_pass != 0) ? draw.wireframe_color : draw.color;
+       gl_Position = projection * view * model * draw.world * vec4(draw.position_offset.xyz + VertexPos * draw.position_scale.xyz, 1.0); 
+    }
+)";
+
+static const char* BatchedBasicFragmentShaderSource = R"(
+
+    #version 430 core
+
+    out vec4 FragColor;
+
+    flat in vec4 object_color;
+ 
+    void main()
+    {  
+       vec3 mycolor = object_color.rgb;
+
+       float depth  = gl_FragCoord.z;
+
+       vec3 dimming_factor = vec3(depth/2, depth/2, depth/2);
+       mycolor = mycolor - dimming_factor;
+      
+       FragColor = vec4(mycolor, object_color.a);
+    }
+)";
+
+static const char* BatchedSelectVertexShaderSource = R"(
+
+    #version 430 core
+
+    layout(location = 0) in vec3 VertexPos;
+    layout(location = 3) in uint DrawID;
+
+    struct DrawData
+    {
+        vec4 color;
+        vec4 wireframe_color;
+        vec4 position_offset;
+        vec4 position_scale;
+        uint pick_id_base;
+        mat4 world;
+    };
+
+    layout(std430, binding = 0) readonly buffer DrawDataBuffer
+    {
+        DrawData draws[];
+    };
+
+    layout(std140, binding = 1) uniform SceneBlock
+    {
+        mat4 projection;
+        mat4 view;
+        mat4 model;
+        vec4 light_position;
+        vec4 light_ambient;
+        vec4 light_diffuse;
+        vec4 light_specular;
+    };
+
+    flat out uint selection_init_id;
+    
+    void main()
+    {            
+      DrawData draw = draws[DrawID];
+      selection_init_id = draw.pick_id_base;
+      gl_Position = projection * view * model * draw.world * vec4(draw.position_offset.xyz + VertexPos * draw.position_scale.xyz, 1.0);
+    }
+)";
+
+static const char* BatchedSelectPrimitiveFragmentShaderSource = R"(
+
+    #version 430 core
+    
+    out vec4 FragColor;
+
+    flat in uint selection_init_id;
+    
+    void main()
+    {  
+      // gl_PrimitiveID restarts for every command of a multi draw
+      uint PrimID = uint(gl_PrimitiveID) + selection_init_id;
+
+      vec3 unique_color = vec3(1.0, 1.0, 1.0);
+
+      unique_color.b = float((PrimID >> 16) & 0xFF) / 255.0;
+      unique_color.g = float((PrimID >> 8)  & 0xFF) / 255.0;
+      unique_color.r = float(PrimID & 0xFF) / 255.0;
+ 
+      FragColor = vec4(unique_color, 1.0f);
+    }
+)";
+
+static const char* BatchedSelectGeometryFragmentShaderSource = R"(
+
+    #version 430 core
+    
+    out vec4 FragColor;
+
+    flat in uint selection_init_id;
+    
+    void main()
+    {  
+      vec3 unique_color;
+
+      unique_color.b = float((selection_init_id >> 16) & 0xFF) / 255.0;
+      unique_color.g = float((selection_init_id >> 8)  & 0xFF) / 255.0;
+      unique_color.r = float(selection_init_id & 0xFF) / 255.0;
+
+      FragColor = vec4(unique_color, 1.0f);
+    }
+)";
+
+// Integer ID shaders : write the 32 bit pick id to the R32UI attachment of the offscreen pick framebuffer
+// (no RGB encoding, used with the Select / BatchedSelect vertex shaders)
+// Depth peeling : from the second layer on, fragments at or in front of the previous layer's depth are discarded
+
+static const char* IdSelectPrimitiveFragmentShaderSource = R"(
+
+    #version 430 core
+    
+    out uint PickID;
+
+    uniform uint selection_init_id;
+    layout(binding = 4) uniform sampler2D peel_depth;
+    uniform int peel_previous_layer;
+    
+    void main()
+    {  
+      if(peel_previous_layer != 0 && gl_FragCoord.z <= texelFetch(peel_depth, ivec2(gl_FragCoord.xy), 0).r) discard;
+      PickID = uint(gl_PrimitiveID) + selection_init_id;
+    }
+)";
+
+static const char* IdSelectGeometryFragmentShaderSource = R"(
+
+    #version 430 core
+    
+    out uint PickID;
+
+    uniform uint selection_init_id;
+    layout(binding = 4) uniform sampler2D peel_depth;
+    uniform int peel_previous_layer;
+    
+    void main()
+    {  
+      if(peel_previous_layer != 0 && gl_FragCoord.z <= texelFetch(peel_depth, ivec2(gl_FragCoord.xy), 0).r) discard;
+      PickID = selection_init_id;
+    }
+)";
+
+static const char* BatchedIdSelectPrimitiveFragmentShaderSource = R"(
+
+    #version 430 core
+    
+    out uint PickID;
+
+    flat in uint selection_init_id;
+    layout(binding = 4) uniform sampler2D peel_depth;
+    uniform int peel_previous_layer;
+    
+    void main()
+    {  
+      if(peel_previous_layer != 0 && gl_FragCoord.z <= texelFetch(peel_depth, ivec2(gl_FragCoord.xy), 0).r) discard;
+      // gl_PrimitiveID restarts for every command of a multi draw
+      PickID = uint(gl_PrimitiveID) + selection_init_id;
+    }
+)";
+
+static const char* BatchedIdSelectGeometryFragmentShaderSource = R"(
+
+    #version 430 core
+    
+    out uint PickID;
+
+    flat in uint selection_init_id;
+    layout(binding = 4) uniform sampler2D peel_depth;
+    uniform int peel_previous_layer;
+    
+    void main()
+    {  
+      if(peel_previous_layer != 0 && gl_FragCoord.z <= texelFetch(peel_depth, ivec2(gl_FragCoord.xy), 0).r) discard;
+      PickID = selection_init_id;
+    }
+)";
+
+// Instanced shaders : one draw of a shared geometry per instance (glDrawElementsInstanced), the per instance transform
+// and color are divisor 1 attributes (GL_INSTANCE_TRANSFORM_LOCATION = 4..7, GL_INSTANCE_COLOR_LOCATION = 8).
+// Pick ids are selection_init_id + instance * instance_pick_stride + (vertex / primitive id inside the instance)
+
+static const char* InstancedBasicVertexShaderSource = R"(
+
+    #version 430 core
+
+    layout(location = 0) in vec3 VertexPos;
+    layout(location = 4) in mat4 InstanceWorld;
+    layout(location = 8) in vec4 InstanceColor;
+
+    layout(std140, binding = 1) uniform SceneBlock
+    {
+        mat4 projection;
+        mat4 view;
+        mat4 model;
+        vec4 light_position;
+        vec4 light_ambient;
+        vec4 light_diffuse;
+        vec4 light_specular;
+    };
+
+    uniform vec3 position_offset;
+    uniform vec3 position_scale;
+    uniform mat4 entity_world;
+
+    // Primitive set (or wireframe) color, replaced by the instance color when use_instance_color is set
+    uniform vec4 fallback_color;
+    uniform int  use_instance_color;
+
+    flat out vec4 object_color;
+
+    void main()
+    {    
+       object_color = (use_instance_color != 0) ? InstanceColor : fallback_color;
+       gl_Position = projection * view * model * entity_world * InstanceWorld * vec4(position_offset + VertexPos * position_scale, 1.0); 
+    }
+)";
+
+static const char* InstancedSelectVertexShaderSource = R"(
+
+    #version 430 core
+
+    layout(location = 0) in vec3 VertexPos;
+    layout(location = 4) in mat4 InstanceWorld;
+
+    layout(std140, binding = 1) uniform SceneBlock
+    {
+        mat4 projection;
+        mat4 view;
+        mat4 model;
+        vec4 light_position;
+        vec4 light_ambient;
+        vec4 light_diffuse;
+        vec4 light_specular;
+    };
+
+    uniform vec3 position_offset;
+    uniform vec3 position_scale;
+    uniform mat4 entity_world;
+
+    flat out uint instance_index;
+    
+    void main()
+    {            
+      instance_index = uint(gl_InstanceID);
+      gl_Position = projection * view * model * entity_world * InstanceWorld * vec4(position_offset + VertexPos * position_scale, 1.0);
+    }
+)";
+
+static const char* InstancedSelectFragmentShaderSource = R"(
+
+    #version 430 core
+    
+    out vec4 FragColor;
+
+    flat in uint instance_index;
+
+    uniform uint selection_init_id;
+    uniform uint instance_pick_stride;
+    // 1 : primitive / vertex ids (gl_PrimitiveID restarts for every instance), 0 : one id per instance
+    uniform int  pick_primitives;
+    
+    void main()
+    {  
+      uint PickID = selection_init_id + instance_index * instance_pick_stride + (pick_primitives != 0 ? uint(gl_PrimitiveID) : 0u);
+
+      vec3 unique_color;
+
+      unique_color.b = float((PickID >> 16) & 0xFF) / 255.0;
+      unique_color.g = float((PickID >> 8)  & 0xFF) / 255.0;
+      unique_color.r = float(PickID & 0xFF) / 255.0;
+ 
+      FragColor = vec4(unique_color, 1.0f);
+    }
+)";
+
+static const char* InstancedIdSelectFragmentShaderSource = R"(
+
+    #version 430 core
+    
+    out uint PickID;
+
+    flat in uint instance_index;
+
+    uniform uint selection_init_id;
+    uniform uint instance_pick_stride;
+    uniform int  pick_primitives;
+    layout(binding = 4) uniform sampler2D peel_depth;
+    uniform int peel_previous_layer;
+    
+    void main()
+    {  
+      if(peel_previous_layer != 0 && gl_FragCoord.z <= texelFetch(peel_depth, ivec2(gl_FragCoord.xy), 0).r) discard;
+      PickID = selection_init_id + instance_index * instance_pick_stride + (pick_primitives != 0 ? uint(gl_PrimitiveID) : 0u);
+    }
+)";
+
 }
 
 } // namespace gridpro_gui
@@ -0,0 +1,138 @@
+#ifndef GP_GUI_SLOT_MAP_H
+#define GP_GUI_SLOT_MAP_H
+
+#include <cstdint>
+#include <vector>
+
+namespace gridpro_gui
+{
+    /// @brief Generational reference into a SlotMap (stale once its value is erased, even if the slot is reused)
+    struct SlotHandle
+    {
+        uint32_t slot;
+        uint32_t generation;
+        SlotHandle() : slot(UINT32_MAX), generation(0) {}
+        SlotHandle(const uint32_t slot_, const uint32_t generation_) : slot(slot_), generation(generation_) {}
+    };
+
+    ///////////////////////////////////////////////////////
+    ////////// Slot Map
+    ///////////////////////////////////////////////////////
+    ///// Values are stored densely (iteration is a plain vector walk) and addressed through
+    ///// slots that never move. Erase moves the last value into the hole (swap and pop) and
+    ///// bumps the generation of the slot, so insert, erase and lookup are all O(1) and old
+    ///// handles are detected instead of aliasing the next value in the slot.
+    ///// Usage :
+    ///// SlotHandle handle = slot_map.insert(value);
+    ///// if(T* value = slot_map.get(handle)) { ... }
+    ///// ----------
+    ///// slot_map.erase(handle.slot);
+    ///////////////////////////////////////////////////////
+    template<typename T>
+    class SlotMap
+    {
+      public :
+      typedef typename std::vector<T>::iterator       iterator;
+      typedef typename std::vector<T>::const_iterator const_iterator;
+
+      /// @brief Store a value in a free slot (or a new one)
+      SlotHandle insert(const T& value)
+      {
+          uint32_t slot;
+          if(!m_free_slots.empty())
+          {
+              slot = m_free_slots.back();
+              m_free_slots.pop_back();
+          }
+          else
+          {
+              slot = static_cast<uint32_t>(m_slots.size());
+              m_slots.push_back(Slot{INVALID_INDEX, 0});
+          }
+          m_slots[slot].dense_index = static_cast<uint32_t>(m_values.size());
+          m_values.push_back(value);
+          m_dense_slots.push_back(slot);
+          return SlotHandle(slot, m_slots[slot].generation);
+      }
+
+      /// @brief Remove the value of a slot (the last value takes its dense position)
+      bool erase(const uint32_t slot)
+      {
+          if(!contains(slot)) return false;
+
+          const uint32_t hole = m_slots[slot].dense_index;
+          const uint32_t last = static_cast<uint32_t>(m_values.size()) - 1;
+          if(hole != last)
+          {
+              m_values[hole]      = m_values[last];
+              m_dense_slots[hole] = m_dense_slots[last];
+              m_slots[m_dense_slots[hole]].dense_index = hole;
+          }
+          m_values.pop_back();
+          m_dense_slots.pop_back();
+
+          m_slots[slot].dense_index = INVALID_INDEX;
+          ++m_slots[slot].generation;
+          m_free_slots.push_back(slot);
+          return true;
+      }
+
+      const bool contains(const uint32_t slot) const { return slot < m_slots.size() && m_slots[slot].dense_index != INVALID_INDEX; }
+      const bool contains(const SlotHandle& handle) const { return contains(handle.slot) && m_slots[handle.slot].generation == handle.generation; }
+
+      /// @brief Value of a live handle, nullptr if it was erased
+      T* get(const SlotHandle& handle) { return contains(handle) ? &m_values[m_slots[handle.slot].dense_index] : nullptr; }
+      T* get(const uint32_t slot)      { return contains(slot)   ? &m_values[m_slots[slot].dense_index]        : nullptr; }
+
+      /// @brief Current handle of a live slot
+      SlotHandle handle(const uint32_t slot) const { return SlotHandle(slot, slot < m_slots.size() ? m_slots[slot].generation : 0); }
+      /// @brief Slot of the value at a dense position (iteration order)
+      const uint32_t slot_at(const size_t dense_index) const { return m_dense_slots[dense_index]; }
+
+      /// @brief Capacity for count more values without reallocation
+      void reserve(const size_t count)
+      {
+          m_values.reserve(m_values.size() + count);
+          m_dense_slots.reserve(m_dense_slots.size() + count);
+          m_slots.reserve(m_slots.size() + (count > m_free_slots.size() ? count - m_free_slots.size() : 0));
+      }
+
+      void clear()
+      {
+          for(uint32_t slot : m_dense_slots)
+          {
+              m_slots[slot].dense_index = INVALID_INDEX;
+              ++m_slots[slot].generation;
+              m_free_slots.push_back(slot);
+          }
+          m_values.clear();
+          m_dense_slots.clear();
+      }
+
+      const size_t size() const { return m_values.size(); }
+      const bool empty() const { return m_values.empty(); }
+      T& back() { return m_values.back(); }
+      T& operator[](const size_t dense_index) { return m_values[dense_index]; }
+
+      iterator begin() { return m_values.begin(); }
+      iterator end()   { return m_values.end(); }
+      const_iterator begin() const { return m_values.begin(); }
+      const_iterator end()   const { return m_values.end(); }
+
+      private :
+      static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+      struct Slot
+      {
+          uint32_t dense_index;
+          uint32_t generation;
+      };
+
+      std::vector<T>        m_values;
+      std::vector<uint32_t> m_dense_slots;   /// Slot of every value
+      std::vector<Slot>     m_slots;
+      std::vector<uint32_t> m_free_slots;
+    };
+}
+
+#endif // GP_GUI_SLOT_MAP_H
@@ -0,0 +1,75 @@
+#ifndef GP_GUI_STREAMING_UPLOADER_H
+#define GP_GUI_STREAMING_UPLOADER_H
+
+#include "gp_gui_renderer_api.h"
+#include "gp_gui_instrumentation.h"
+#include <array>
+
+namespace gridpro_gui
+{
+    ///////////////////////////////////////////////////////
+    ////////// Streaming Uploader
+    ///////////////////////////////////////////////////////
+    ///// A triple buffered staging ring for geometry that is rewritten every frame.
+    ///// With GL 4.4 glBufferStorage the ring is persistently mapped and each segment is
+    ///// guarded by a fence, so the CPU only waits when it laps the GPU. Without it the
+    ///// ring is orphaned with glBufferData when it wraps.
+    ///// Data is copied from the ring into the destination buffer with glCopyBufferSubData.
+    ///// Usage :
+    ///// StreamingUploader::GetInstance().upload(vbo, offset, size, data);
+    ///// ----------
+    ///// StreamingUploader::GetInstance().end_frame();
+    ///////////////////////////////////////////////////////
+    class StreamingUploader
+    {
+      public :
+      static StreamingUploader& GetInstance()
+      {
+          static StreamingUploader instance;
+          return instance;
+      }
+
+      /// @brief Stage size bytes of data and copy them into dst_buffer at dst_offset
+      void upload(const GLuint dst_buffer, const GLintptr dst_offset, const GLsizeiptr size, const void* data);
+
+      /// @brief Fence the segment written this frame and move to the next one
+      void end_frame();
+
+      /// @brief Delete the ring buffer and the pending fences (call with the context current)
+      void release();
+
+      /// @brief True if the ring is a persistently mapped glBufferStorage buffer
+      const bool is_persistent() const { return m_persistent; }
+
+      /// @brief Fence wait statistics of the ring
+      const Instrumentation::FenceWaitStatistics& get_fence_statistics() const { return m_fence_statistics; }
+      void reset_fence_statistics() { m_fence_statistics.reset(); }
+
+      private :
+      StreamingUploader();
+     ~StreamingUploader() = default;
+      StreamingUploader(const StreamingUploader&) = delete;
+      StreamingUploader& operator=(const StreamingUploader&) = delete;
+
+      void init();
+      void advance_segment();
+      void wait_for_segment(const uint32_t segment);
+      GLubyte* map_range(const GLintptr ring_offset, const GLsizeiptr size);
+      void unmap_range();
+
+      static const uint32_t NUM_SEGMENTS = 3;
+
+      GLuint     m_ring_buffer;
+      GLubyte*   m_mapped_ring;
+      GLsizeiptr m_segment_size;
+      GLsizeiptr m_segment_head;
+      uint32_t   m_segment;
+      bool       m_persistent;
+      bool       m_init_flag;
+      std::array<GLsync, NUM_SEGMENTS> m_fences;
+
+      Instrumentation::FenceWaitStatistics m_fence_statistics;
+    };
+}
+
+#endif // GP_GUI_STREAMING_UPLOADER_H
@@ -10,6 +10,25 @@
 /// @details disable this flag to do manual dirty flag management for slightly performance improvement
 #define _ENABLE_AUTOMATIC_DIRTY_FLAG_MANAGEMENT_
 
+/// @brief Enable this flag to suballocate the VBOs / IBOs of all entities from shared buffer pages
+/// @details Entities then draw with base vertex / index offsets into the pages (see GpuBufferArena)
+/// @details disable this flag to give every VertexArrayObject its own buffer objects
+#define _ENABLE_GPU_BUFFER_ARENA_
+
+/// @brief Enable this flag to draw arena backed entities with glMultiDrawElementsIndirect (see BatchedRenderPath)
+/// @details disable this flag to draw every entity with its own draw call
+#define _ENABLE_BATCHED_RENDER_PATH_
+
+/// @brief Enable this flag to read the pick image back asynchronously through a ring of pixel pack buffers
+/// @details picking then uses an image up to GL_PICK_READBACK_LATENCY frames old without stalling the pipeline
+/// @details disable this flag to read the current frame with blocking glReadPixels
+#define _ENABLE_ASYNC_PICK_READBACK_
+
+/// @brief Enable this flag to render the pick pass into an offscreen framebuffer with an R32UI id attachment
+/// @details ids are written and read as raw 32 bit values and the visible frame is never touched
+/// @details disable this flag to render RGB encoded (24 bit) ids into the back buffer
+#define _ENABLE_INTEGER_PICK_BUFFER_
+
 /// @brief inline macro for header only implementation (optional)
 #define __INLINE__  
 
@@ -146,4 +165,56 @@ typedef double		    GLclampd;	/* double precision float in [0,1] */
 #define GL_COLOR_PER_PRIMITIVE 1
 #define GL_COLOR_PER_PRIMITIVE_SET 2
 
+// Vertex Buffer Layouts
+#define GL_VERTEX_LAYOUT_PLANAR      0
+#define GL_VERTEX_LAYOUT_INTERLEAVED 1
+
+// Vertex Compression Modes
+#define GL_VERTEX_COMPRESSION_NONE      0
+#define GL_VERTEX_COMPRESSION_QUANTIZED 1
+
+// Buffer Usage Hints
+#define GL_BUFFER_USAGE_STATIC 0
+#define GL_BUFFER_USAGE_STREAM 1
+
+// Streaming Uploader (triple buffered staging ring)
+#define GL_STREAMING_SEGMENT_SIZE       (4 * 1024 * 1024)
+#define GL_STREAMING_FENCE_TIMEOUT_NS   1000000
+
+// Asynchronous Commit Pipeline (GL upload time budget per scene update)
+#define GL_COMMIT_BUDGET_MS 4.0
+
+// GPU Buffer Arena page size (larger allocations get a page of their own)
+#define GL_BUFFER_ARENA_PAGE_SIZE (64 * 1024 * 1024)
+
+// Batched Render Path SSBO binding of the per draw data
+#define GL_BATCH_DRAW_DATA_BINDING 0
+
+// Hardware instancing attribute locations (divisor 1) : transform columns at 4..7, RGBA color at 8
+// (must match the locations of InstanceWorld / InstanceColor in gp_gui_shader_src.h)
+#define GL_INSTANCE_TRANSFORM_LOCATION 4
+#define GL_INSTANCE_COLOR_LOCATION     8
+
+// Uniform block binding of the scene wide matrices / light (must match the binding of SceneBlock in gp_gui_shader_src.h)
+#define GL_SCENE_UNIFORM_BLOCK_BINDING 1
+
+// Pick image readback ring (maximum age in frames of the pick image, see framebuffer::set_readback_latency)
+#define GL_PICK_READBACK_LATENCY     2
+#define GL_PICK_READBACK_MAX_LATENCY 3
+
+// Default side in pixels of the region of interest read back around the cursor (framebuffer::enable_region_of_interest)
+#define GL_PICK_ROI_SIZE 32
+
+// First pick id handed out by the scene (ids below are never used by entities)
+#define GL_PICK_ID_BASE 1000000
+
+// Depth peeled pick pass : maximum number of id layers and the texture unit of the previous layer's depth
+// (the unit must match the binding of peel_depth in gp_gui_shader_src.h)
+#define GL_PICK_MAX_PEEL_LAYERS 8
+#define GL_PICK_PEEL_DEPTH_TEXTURE_UNIT 4
+
+// CPU ray pick defaults (object units) : hit distance of lines and radius of points (see RayPickEngine::set_tolerance)
+#define GL_RAY_PICK_LINE_TOLERANCE 0.01f
+#define GL_RAY_PICK_POINT_RADIUS   0.01f
+
 #endif
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define GP_GUI_VERTEX_ARRAY_OBJECT_H
 
 #include "gp_gui_renderer_api.h"
+#include "gp_gui_buffer_arena.h"
+#include <array>
 
 
 namespace gridpro_gui
@@ -13,12 +15,72 @@ namespace gridpro_gui
        public :
        VertexArrayObject();
        VertexArrayObject(GeometryDescriptor* geometry_descriptor);
-       VertexArrayObject(std::vector<float>* position_data = nullptr, std::vector<float>* normal_data = nullptr, std::vector<GLubyte>* color_data = nullptr);
+       VertexArrayObject(std::vector<float>* position_data, std::vector<float>* normal_data = nullptr, std::vector<GLubyte>* color_data = nullptr);
       ~VertexArrayObject();
        
        void set_vertex_attribute(std::vector<float>* position_data, std::vector<float>* normal_data, std::vector<GLubyte>* color_data);
        void set_indices(std::vector<uint32_t>* index_data); 
 
+       /// @brief Select planar (separate blocks) or interleaved (pos + normal + color per stride) vertex buffer layout
+       /// @note  Takes effect on the next create_vbo() / update_vbo()
+       void set_interleaved(const bool interleaved) { m_interleaved = interleaved; }
+       const bool is_interleaved() const { return m_interleaved; }
+
+       /// @brief Enable quantized attributes (16 bit unorm positions, octahedral normals, 16 bit indices when possible)
+       /// @note  Takes effect on the next create_vbo() / update_vbo()
+       void set_quantized(const bool quantized) { m_quantized = quantized; }
+       const bool is_quantized() const { return m_quantized; }
+
+       /// @brief Route buffer updates through the StreamingUploader ring (GL_DYNAMIC_DRAW storage)
+       /// @note  Takes effect on the next create_vbo() / update_vbo()
+       void set_streamed(const bool streamed) { m_streamed = streamed; }
+       const bool is_streamed() const { return m_streamed; }
+
+       /// @brief Dequantization for the shaders : position = offset + VertexPos * scale (identity when not quantized)
+       const std::array<float, 3>& get_position_offset() const { return m_position_offset; }
+       const std::array<float, 3>& get_position_scale()  const { return m_position_scale;  }
+
+       /// @brief Index type of the element array buffer (GL_UNSIGNED_INT or GL_UNSIGNED_SHORT)
+       const GLenum get_index_type() const { return m_index_type; }
+
+       /// @brief Draw parameters into the shared arena pages (both 0 for private buffers)
+       /// @details Interleaved ranges are stride aligned and addressed with a base vertex, planar ranges through the attribute offsets
+       const GLint    get_base_vertex()  const { return (m_vbo_allocation.is_valid() && m_interleaved && m_stride) ? static_cast<GLint>(m_vbo_offset / m_stride) : 0; }
+       const GLintptr get_index_offset() const { return m_ibo_offset; }
+       const GLuint   get_first_index()  const { return static_cast<GLuint>(m_ibo_offset / (m_index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t))); }
+
+       /// @brief True for indexed, interleaved arena ranges. Those can share one VAO per page and vertex format (batched render path)
+       const bool is_batchable() const { return m_vbo_allocation.is_valid() && m_ibo_allocation.is_valid() && m_interleaved && m_stride && m_vao; }
+       const GLuint get_vbo() const { return m_vbo; }
+       const GLuint get_ibo() const { return m_ibo; }
+
+       /// @brief Signature of the attribute state : stride, quantization, normals, color components
+       const uint32_t get_vertex_format() const
+       { return m_stride | (m_quantized ? 1u << 16 : 0u) | (nSize ? 1u << 17 : 0u) | (cSize ? 1u << 18 : 0u) | (cComponents == 4 ? 1u << 19 : 0u); }
+
+       /// @brief Bind this object's buffers and specify its attribute format on the currently bound (shared) VAO
+       void specify_attribute_format();
+
+       /// @brief Pack the current primitive set of the descriptor into upload-ready blobs without any GL call
+       /// @note  Safe on a worker thread as long as the descriptor is not modified meanwhile
+       void stage(GeometryDescriptor* geometry_descriptor);
+
+       /// @brief Create the VAO, VBO and IBO from the staged blobs and release them (GL thread only)
+       void upload_staged();
+       const bool is_staged() const { return m_staged; }
+
+       /// @brief upload_staged() for many objects at once : the arena backed ones share one vertex and one index
+       /// @brief allocation (GpuBufferArena::allocate_batch) filled with a single mapped write per pool (GL thread only)
+       static void upload_staged_batch(const std::vector<VertexArrayObject*>& objects);
+
+       /// @brief Per instance attributes of instanced primitive sets, kept in a private buffer next to the vertex storage :
+       /// @brief transform columns at GL_INSTANCE_TRANSFORM_LOCATION.., RGBA color at GL_INSTANCE_COLOR_LOCATION (divisor 1)
+       /// @note  Empty transforms release the buffer. Colors are used only if there is one per instance
+       void set_instance_attributes(const std::vector<float>& transforms, const std::vector<GLubyte>& colors);
+       void delete_instance_buffer();
+       const GLsizei get_num_instances() const { return m_num_instances; }
+       const bool has_instance_colors() const  { return m_instance_colors; }
+
        void bind();
        void unbind();
        
@@ -40,6 +102,9 @@ namespace gridpro_gui
        /// @return  The size of the vertex array object in bytes
        const size_t get_vbo_size() const { return m_vbo_curr_size; }
 
+       /// @brief   Get the byte distance between two consecutive vertices (0 for planar layout)
+       const uint32_t get_stride() const { return m_stride; }
+
 
        /// @brief Get which vertex attribute data is present
        const bool has_normal_attrib() const { return (NormalData != nullptr && NormalData->size()) ? 1 : 0; }
@@ -49,13 +114,115 @@ namespace gridpro_gui
        const bool has_index_data() const { return (IndexData != nullptr && IndexData->size()) ? 1 : 0; }
 
        private :
+       /// @brief Set the attribute pointers (location 0 = position, 1 = normal, 2 = color) for the current layout
+       void set_vertex_attribute_pointers();
+
+       /// @brief Set the divisor 1 attribute pointers of the instance buffer on the bound VAO
+       void set_instance_attribute_pointers();
+
+       /// @brief Pack positions, normals and colors of vertices [first, last) into one interleaved staging array
+       void pack_interleaved_vertex_range(const size_t first, const size_t last, std::vector<GLubyte>& packed_data) const;
+
+       /// @brief Upload elements [first, last) of one planar attribute block (0 = position, 1 = normal, 2 = color bytes)
+       void upload_planar_range(const uint32_t attribute, const size_t first, const size_t last);
+
+       /// @brief Convert the dirty byte intervals of a descriptor array into element intervals (whole array if none recorded)
+       void collect_dirty_elements(const uint32_t array_type, const uint32_t dirty_flag, const size_t element_bytes, const size_t element_count,
+                                   std::vector<std::pair<size_t, size_t>>& element_ranges) const;
+
+       /// @brief glBufferSubData on the bound buffer, or a staged copy through the StreamingUploader when streamed
+       void buffer_sub_data(const GLenum target, const GLuint buffer, const GLintptr offset, const GLsizeiptr size, const void* data);
+       const GLenum buffer_usage() const { return m_streamed ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW; }
+
+       /// @brief Full VBO / IBO image for the current layout (GL free)
+       void pack_vertex_data(std::vector<GLubyte>& vertex_data) const;
+       void pack_index_data(std::vector<GLubyte>& index_data) const;
+
+       /// @brief Upload only the dirty intervals of the descriptor into the bound VBO
+       void upload_dirty_vertex_ranges();
+
+       /// @brief Write the (possibly quantized) position / normal of vertex i to dst
+       void write_position(const size_t i, GLubyte* dst) const;
+       void write_normal(const size_t i, GLubyte* dst) const;
+
+       /// @brief Compute the position dequantization offset and scale from the bounding box
+       void calculate_dequantization();
+
+       /// @brief Specify the bound element array buffer with 32 or 16 bit indices
+       void upload_index_data();
+       GLenum select_index_type() const;
+
+       /// @brief Byte layout of the last full upload. Partial updates are only valid while it is unchanged
+       struct UploadedLayout
+       {
+           UploadedLayout() : interleaved(false), quantized(false), streamed(false), vSize(0), nSize(0), cSize(0), position_offset{{0.0f, 0.0f, 0.0f}}, position_scale{{0.0f, 0.0f, 0.0f}} {}
+           bool interleaved, quantized, streamed;
+           uint32_t vSize, nSize, cSize;
+           std::array<float, 3> position_offset, position_scale;
+
+           bool operator==(const UploadedLayout& other) const
+           {
+               return interleaved == other.interleaved && quantized == other.quantized && streamed == other.streamed && vSize == other.vSize && nSize == other.nSize &&
+                      cSize == other.cSize && position_offset == other.position_offset && position_scale == other.position_scale;
+           }
+       };
+       UploadedLayout current_layout() const;
+
+       /// @brief Buffer storage : a range of the GpuBufferArena or a private buffer (streamed sets, or arena disabled)
+       const bool use_buffer_arena() const;
+       const GLsizeiptr vertex_alignment() const { return m_interleaved ? m_stride : 16; }
+       const bool vertex_storage_matches() const;
+       void allocate_vertex_storage();
+       void allocate_index_storage(const GLsizeiptr index_bytes);
+
+       /// @brief Finish upload_staged() on ranges whose data was already written by upload_staged_batch()
+       void adopt_staged_storage(const GpuBufferArena::Allocation& vertex_range, const GpuBufferArena::Allocation& index_range);
+
+       /// @brief Upload the vertex data of the current layout into the bound VBO
+       void upload_vertex_data();
+
+       /// @brief Re-read the attribute arrays and layout of the current primitive set of the descriptor
+       void refresh_descriptor_state();
+
        uint32_t m_vao, m_vbo, m_ibo;
        
        uint32_t vSize, nSize, cSize;
             
        uint32_t vOffset, nOffset, cOffset;
 
+       /// @brief Interleaved layout state. cComponents is 3 (RGB) or 4 (RGBA)
+       bool     m_interleaved;
+       uint32_t m_stride;
+       uint32_t cComponents;
+
+       /// @brief Bytes required by the current layout (planar : vSize + nSize + cSize, interleaved : vertices * stride)
+       uint32_t m_vbo_data_size;
+
+       /// @brief Quantization state. Positions use 4x16 bit (w is padding), normals 2x16 bit when quantized
+       bool     m_quantized;
+       bool     m_streamed;
+       uint32_t m_position_bytes, m_normal_bytes;
+       std::array<float, 3> m_position_offset, m_position_scale;
+       GLenum   m_index_type;
+
+       UploadedLayout m_uploaded_layout;
+
+       /// @brief Blobs prepared by stage() and consumed by upload_staged()
+       std::vector<GLubyte> m_staged_vertices, m_staged_indices;
+       bool m_staged;
+
        uint32_t m_vbo_curr_size, m_ibo_curr_size;
+
+       /// @brief Arena ranges backing m_vbo / m_ibo (invalid for private buffers) and their byte offsets
+       GpuBufferArena::Allocation m_vbo_allocation, m_ibo_allocation;
+       GLintptr   m_vbo_offset, m_ibo_offset;
+       GLsizeiptr m_ibo_bytes;
+
+       /// @brief Instance buffer (transforms, then colors), its size in bytes and the number of instances it holds
+       GLuint     m_instance_vbo;
+       GLsizeiptr m_instance_bytes;
+       GLsizei    m_num_instances;
+       bool       m_instance_colors;
         
        GeometryDescriptor* m_geometry_descriptor;
 
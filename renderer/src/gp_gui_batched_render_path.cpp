@@ -0,0 +1,214 @@
+#include "gp_gui_batched_render_path.h"
+#include "gp_gui_opengl_3_3_render_kernel.h"
+#include "gp_gui_vertex_array_object.h"
+#include "gp_gui_buffer_arena.h"
+#include "gp_gui_shader.h"
+#include "gp_gui_communications.h"
+#include "gp_gui_events.h"
+#include "gp_gui_gl_state_cache.h"
+#include <numeric>
+
+namespace gridpro_gui
+{
+    namespace
+    {
+        constexpr UniformName WIREFRAME_PASS("wireframe_pass");
+        constexpr UniformName PEEL_PREVIOUS_LAYER("peel_previous_layer");
+    }
+
+    BatchedRenderPath::BatchedRenderPath()
+    : m_indirect_buffer(0), m_draw_data_buffer(0), m_draw_id_buffer(0), m_draw_id_capacity(0),
+      m_selection_mode(false), m_init_flag(false), m_arena_generation(0), m_draw_count(0), m_batch_count(0)
+    {
+
+    }
+
+    BatchedRenderPath::~BatchedRenderPath()
+    {
+        if(!m_init_flag) return;
+
+        release_shared_vaos();
+        Renderer::GL_API()->glDeleteBuffers(1, &m_indirect_buffer);
+        Renderer::GL_API()->glDeleteBuffers(1, &m_draw_data_buffer);
+        Renderer::GL_API()->glDeleteBuffers(1, &m_draw_id_buffer);
+    }
+
+    void BatchedRenderPath::init()
+    {
+        if(m_init_flag) return;
+        Renderer::GL_API()->glGenBuffers(1, &m_indirect_buffer);
+        Renderer::GL_API()->glGenBuffers(1, &m_draw_data_buffer);
+        Renderer::GL_API()->glGenBuffers(1, &m_draw_id_buffer);
+        m_init_flag = true;
+    }
+
+    void BatchedRenderPath::begin(const bool selection_mode)
+    {
+        m_selection_mode = selection_mode;
+        m_batches.clear();
+    }
+
+    bool BatchedRenderPath::submit(OpenGL_3_3_RenderKernel& kernel)
+    {
+        BatchedDrawRecord draw;
+        if(!kernel.prepare_batched_draw(m_selection_mode, draw)) return false;
+
+        m_batches[draw.key].push_back(draw);
+        return true;
+    }
+
+    void BatchedRenderPath::flush()
+    {
+        m_draw_count  = 0;
+        m_batch_count = 0;
+        if(m_batches.empty()) return;
+
+        init();
+
+        /// Every batch occupies a contiguous range of commands, baseInstance is the global draw id
+        std::vector<DrawElementsIndirectCommand> commands;
+        std::vector<BatchedDrawData> draw_data;
+        for(auto& batch : m_batches)
+        {
+            for(BatchedDrawRecord& draw : batch.second)
+            {
+                draw.command.baseInstance = static_cast<GLuint>(commands.size());
+                commands.push_back(draw.command);
+                draw_data.push_back(draw.data);
+            }
+        }
+        reserve_draw_ids(commands.size());
+
+        Renderer::GL_API()->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirect_buffer);
+        Renderer::GL_API()->glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_STREAM_DRAW);
+        Renderer::GL_API()->glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_draw_data_buffer);
+        Renderer::GL_API()->glBufferData(GL_SHADER_STORAGE_BUFFER, draw_data.size() * sizeof(BatchedDrawData), draw_data.data(), GL_STREAM_DRAW);
+        Renderer::GL_API()->glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GL_BATCH_DRAW_DATA_BINDING, m_draw_data_buffer);
+
+        std::shared_ptr<Shader> shader;
+        size_t first_command = 0;
+
+        for(auto& batch : m_batches)
+        {
+            const BatchKey& key  = batch.first;
+            const size_t   count = batch.second.size();
+
+            shader = ShaderLibrary::GetShader(key.shader_name);
+            shader->bind();
+
+            GLStateCache::GetInstance().bind_vertex_array(get_shared_vao(batch.second.front()));
+
+            /// Same passes as OpenGL_3_3_RenderKernel::render_display_mode / render_selection_mode
+            if(!m_selection_mode && key.wireframe_mode == GL_WIREFRAME_OVERLAY)
+            {
+                shader->Set1i(WIREFRAME_PASS, 0);
+                multi_draw(key, first_command, count);
+            }
+            if(!m_selection_mode)
+                shader->Set1i(WIREFRAME_PASS, 1);
+            else if(Event::Publisher::GetInstance()->frame_buffer()->uses_integer_ids())
+                shader->Set1i(PEEL_PREVIOUS_LAYER, Event::Publisher::GetInstance()->frame_buffer()->current_peel_layer() > 0 ? 1 : 0);
+
+            apply_rasteriser_state(key.wireframe_mode);
+            multi_draw(key, first_command, count);
+            reset_rasteriser_state(key.wireframe_mode);
+
+            first_command += count;
+        }
+
+        GLStateCache::GetInstance().bind_vertex_array(0);
+        Renderer::GL_API()->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        Renderer::GL_API()->glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        if(shader) shader->unbind();
+
+        m_draw_count  = commands.size();
+        m_batch_count = m_batches.size();
+        m_batches.clear();
+        DEBUG_PRINT("Batched ", m_draw_count, " draws into ", m_batch_count, " multi draw calls");
+    }
+
+    void BatchedRenderPath::multi_draw(const BatchKey& key, const size_t first_command, const size_t command_count)
+    {
+        Renderer::GL_API()->glMultiDrawElementsIndirect(key.primitive_type, key.index_type,
+                                                        (void*)(uintptr_t)(first_command * sizeof(DrawElementsIndirectCommand)),
+                                                        static_cast<GLsizei>(command_count), 0);
+    }
+
+    /// @brief The draw id attribute reads element baseInstance of this buffer (0, 1, 2 ...)
+    void BatchedRenderPath::reserve_draw_ids(const size_t draw_count)
+    {
+        if(draw_count <= m_draw_id_capacity) return;
+
+        m_draw_id_capacity = std::max<size_t>(std::max<size_t>(draw_count, 2 * m_draw_id_capacity), 1024);
+        std::vector<GLuint> draw_ids(m_draw_id_capacity);
+        std::iota(draw_ids.begin(), draw_ids.end(), 0);
+
+        Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_draw_id_buffer);
+        Renderer::GL_API()->glBufferData(GL_ARRAY_BUFFER, draw_ids.size() * sizeof(GLuint), draw_ids.data(), GL_STATIC_DRAW);
+        Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    /// @brief One VAO per (vertex page, index page, vertex format). Interleaved arena ranges have identical attribute state
+    GLuint BatchedRenderPath::get_shared_vao(const BatchedDrawRecord& draw)
+    {
+        /// Page buffer names can be recycled once the arena deletes a page
+        if(m_arena_generation != GpuBufferArena::GetInstance().get_generation())
+        {
+            release_shared_vaos();
+            m_arena_generation = GpuBufferArena::GetInstance().get_generation();
+        }
+
+        const std::tuple<GLuint, GLuint, uint32_t> vao_key(draw.key.vertex_buffer, draw.key.index_buffer, draw.key.vertex_format);
+        std::map<std::tuple<GLuint, GLuint, uint32_t>, GLuint>::iterator it = m_shared_vaos.find(vao_key);
+        if(it != m_shared_vaos.end()) return it->second;
+
+        GLuint vao = 0;
+        Renderer::GL_API()->glGenVertexArrays(1, &vao);
+        GLStateCache::GetInstance().bind_vertex_array(vao);
+
+        draw.vao->specify_attribute_format();
+
+        // Draw id -> location 3
+        Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_draw_id_buffer);
+        Renderer::GL_API()->glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(GLuint), nullptr);
+        Renderer::GL_API()->glVertexAttribDivisor(3, 1);
+        Renderer::GL_API()->glEnableVertexAttribArray(3);
+
+        GLStateCache::GetInstance().bind_vertex_array(0);
+        Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_shared_vaos[vao_key] = vao;
+        return vao;
+    }
+
+    void BatchedRenderPath::release_shared_vaos()
+    {
+        for(auto& shared_vao : m_shared_vaos)
+        {
+            Renderer::GL_API()->glDeleteVertexArrays(1, &shared_vao.second);
+            GLStateCache::GetInstance().on_vertex_array_deleted(shared_vao.second);
+        }
+        m_shared_vaos.clear();
+    }
+
+    void BatchedRenderPath::apply_rasteriser_state(const GLenum& wireframe_mode)
+    {
+        if(wireframe_mode != GL_WIREFRAME_NONE)
+        {
+            GLStateCache::GetInstance().polygon_mode(GL_LINE);
+            GLStateCache::GetInstance().polygon_offset_fill(true);
+            GLStateCache::GetInstance().polygon_offset(1.0f, 1.0f);
+            GLStateCache::GetInstance().line_width(4.0f);
+        }
+    }
+
+    void BatchedRenderPath::reset_rasteriser_state(const GLenum& wireframe_mode)
+    {
+        if(wireframe_mode != GL_WIREFRAME_NONE)
+        {
+            GLStateCache::GetInstance().polygon_offset_fill(false);
+            GLStateCache::GetInstance().polygon_mode(GL_FILL);
+            GLStateCache::GetInstance().line_width(4.0f);
+        }
+    }
+}
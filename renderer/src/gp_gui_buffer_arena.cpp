@@ -0,0 +1,190 @@
+#include "gp_gui_buffer_arena.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace gridpro_gui
+{
+    GpuBufferArena::Allocation GpuBufferArena::allocate(const PoolType pool, const GLsizeiptr size, const GLsizeiptr alignment)
+    {
+        if(size <= 0) throw std::runtime_error("GpuBufferArena : invalid allocation size");
+        const GLsizeiptr align = std::max<GLsizeiptr>(alignment, 1);
+
+        Allocation allocation;
+        allocation.pool = pool;
+        allocation.size = size;
+
+        for(Page& page : m_pages[pool])
+        {
+            if(allocate_from_page(page, size, align, allocation.offset))
+            {
+                allocation.buffer = page.buffer;
+                return allocation;
+            }
+        }
+
+        /// No page has a large enough block, open a new one (oversized requests get a page of their own)
+        Page& page = create_page(pool, size + align);
+        if(!allocate_from_page(page, size, align, allocation.offset))
+            throw std::runtime_error("GpuBufferArena : allocation failed on a fresh page");
+
+        allocation.buffer = page.buffer;
+        return allocation;
+    }
+
+    std::vector<GpuBufferArena::Allocation> GpuBufferArena::allocate_batch(const PoolType pool, const std::vector<GLsizeiptr>& sizes, const std::vector<GLsizeiptr>& alignments)
+    {
+        if(sizes.size() != alignments.size()) throw std::runtime_error("GpuBufferArena : batch sizes and alignments differ in length");
+
+        std::vector<Allocation> allocations(sizes.size());
+        if(sizes.empty()) return allocations;
+
+        /// Worst case span : every range preceded by alignment - 1 bytes of padding
+        GLsizeiptr span = 0;
+        for(size_t i = 0; i < sizes.size(); ++i)
+        {
+            if(sizes[i] <= 0) throw std::runtime_error("GpuBufferArena : invalid allocation size");
+            span += sizes[i] + std::max<GLsizeiptr>(alignments[i], 1) - 1;
+        }
+
+        Page* page = nullptr;
+        GLintptr base = 0;
+        for(Page& candidate : m_pages[pool])
+        {
+            if(allocate_from_page(candidate, span, 1, base)) { page = &candidate; break; }
+        }
+        if(page == nullptr)
+        {
+            page = &create_page(pool, span);
+            if(!allocate_from_page(*page, span, 1, base))
+                throw std::runtime_error("GpuBufferArena : batch allocation failed on a fresh page");
+        }
+
+        /// Lay the ranges out back to back, the padding and the unused tail go back to the free-list
+        GLintptr cursor = base;
+        for(size_t i = 0; i < sizes.size(); ++i)
+        {
+            const GLsizeiptr align   = std::max<GLsizeiptr>(alignments[i], 1);
+            const GLintptr   aligned = ((cursor + align - 1) / align) * align;
+            if(aligned > cursor) free_range(*page, cursor, aligned - cursor);
+
+            allocations[i].buffer = page->buffer;
+            allocations[i].offset = aligned;
+            allocations[i].size   = sizes[i];
+            allocations[i].pool   = pool;
+            cursor = aligned + sizes[i];
+        }
+        if(cursor < base + span) free_range(*page, cursor, base + span - cursor);
+
+        return allocations;
+    }
+
+    /// @brief First-fit search. The alignment padding in front of the range stays in the free-list
+    bool GpuBufferArena::allocate_from_page(Page& page, const GLsizeiptr size, const GLsizeiptr alignment, GLintptr& offset)
+    {
+        for(std::map<GLintptr, GLsizeiptr>::iterator it = page.free_blocks.begin(); it != page.free_blocks.end(); ++it)
+        {
+            const GLintptr block_begin = it->first;
+            const GLintptr block_end   = it->first + it->second;
+            const GLintptr aligned     = ((block_begin + alignment - 1) / alignment) * alignment;
+
+            if(aligned + size > block_end) continue;
+
+            page.free_blocks.erase(it);
+            if(aligned > block_begin)        page.free_blocks[block_begin]    = aligned - block_begin;
+            if(aligned + size < block_end)   page.free_blocks[aligned + size] = block_end - (aligned + size);
+
+            page.bytes_in_use += size;
+            offset = aligned;
+            return true;
+        }
+        return false;
+    }
+
+    GpuBufferArena::Page& GpuBufferArena::create_page(const PoolType pool, const GLsizeiptr min_size)
+    {
+        Page page;
+        page.size         = std::max<GLsizeiptr>(GL_BUFFER_ARENA_PAGE_SIZE, min_size);
+        page.bytes_in_use = 0;
+        page.free_blocks[0] = page.size;
+
+        /// GL_COPY_WRITE_BUFFER keeps the element array binding of the bound VAO untouched
+        Renderer::GL_API()->glGenBuffers(1, &page.buffer);
+        Renderer::GL_API()->glBindBuffer(GL_COPY_WRITE_BUFFER, page.buffer);
+        Renderer::GL_API()->glBufferData(GL_COPY_WRITE_BUFFER, page.size, nullptr, GL_STATIC_DRAW);
+        Renderer::GL_API()->glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        DEBUG_PRINT("GpuBufferArena : new ", (pool == VERTEX_POOL ? "vertex" : "index"), " page of ", page.size, " bytes");
+        m_pages[pool].push_back(page);
+        ++m_generation;
+        return m_pages[pool].back();
+    }
+
+    void GpuBufferArena::release(Allocation& allocation)
+    {
+        if(!allocation.is_valid()) return;
+
+        std::vector<Page>& pages = m_pages[allocation.pool];
+        std::vector<Page>::iterator page = std::find_if(pages.begin(), pages.end(), [&allocation](const Page& p) { return p.buffer == allocation.buffer; });
+        if(page == pages.end()) throw std::runtime_error("GpuBufferArena : released range does not belong to the arena");
+
+        free_range(*page, allocation.offset, allocation.size);
+
+        if(page->bytes_in_use == 0 && page != pages.begin())
+        {
+            Renderer::GL_API()->glDeleteBuffers(1, &page->buffer);
+            pages.erase(page);
+            ++m_generation;
+        }
+
+        allocation = Allocation();
+    }
+
+    void GpuBufferArena::free_range(Page& page, GLintptr begin, GLsizeiptr size)
+    {
+        page.bytes_in_use -= size;
+
+        /// Coalesce with the free neighbours
+        std::map<GLintptr, GLsizeiptr>::iterator next = page.free_blocks.lower_bound(begin);
+        if(next != page.free_blocks.end() && next->first == begin + size)
+        {
+            size += next->second;
+            next = page.free_blocks.erase(next);
+        }
+        if(next != page.free_blocks.begin())
+        {
+            std::map<GLintptr, GLsizeiptr>::iterator prev = std::prev(next);
+            if(prev->first + prev->second == begin)
+            {
+                begin = prev->first;
+                size += prev->second;
+                page.free_blocks.erase(prev);
+            }
+        }
+        page.free_blocks[begin] = size;
+    }
+
+    void GpuBufferArena::release_all()
+    {
+        for(std::vector<Page>& pages : m_pages)
+        {
+            for(Page& page : pages)
+                Renderer::GL_API()->glDeleteBuffers(1, &page.buffer);
+            pages.clear();
+        }
+        ++m_generation;
+    }
+
+    const GLsizeiptr GpuBufferArena::get_bytes_in_use(const PoolType pool) const
+    {
+        GLsizeiptr bytes = 0;
+        for(const Page& page : m_pages[pool]) bytes += page.bytes_in_use;
+        return bytes;
+    }
+
+    const GLsizeiptr GpuBufferArena::get_bytes_reserved(const PoolType pool) const
+    {
+        GLsizeiptr bytes = 0;
+        for(const Page& page : m_pages[pool]) bytes += page.size;
+        return bytes;
+    }
+}
@@ -0,0 +1,127 @@
+#include "gp_gui_commit_pipeline.h"
+#include "gp_gui_scene.h"
+#include "gp_gui_entity_handle.h"
+#include "gp_gui_geometry_descriptor.h"
+#include "gp_gui_vertex_array_object.h"
+#include "gp_gui_opengl_3_3_render_kernel.h"
+#include <chrono>
+#include <iostream>
+
+namespace gridpro_gui
+{
+    GeometryCommitPipeline::GeometryCommitPipeline(const size_t num_workers) : m_stop(false)
+    {
+        /// Leave one hardware thread to the GL / UI thread by default
+        const size_t hardware_threads = std::thread::hardware_concurrency();
+        size_t worker_count = num_workers;
+        if(worker_count == 0)
+            worker_count = hardware_threads > 1 ? hardware_threads - 1 : 1;
+
+        for(size_t i = 0; i < worker_count; ++i)
+            m_workers.emplace_back(&GeometryCommitPipeline::worker_loop, this);
+    }
+
+    GeometryCommitPipeline::~GeometryCommitPipeline()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+
+        for(std::thread& worker : m_workers)
+            if(worker.joinable()) worker.join();
+    }
+
+    void GeometryCommitPipeline::submit(const std::string& entity_key, const std::shared_ptr<GeometryDescriptor>& descriptor)
+    {
+        if(descriptor == nullptr) throw std::runtime_error("GeometryCommitPipeline : descriptor for " + entity_key + " is null");
+
+        std::shared_ptr<CommitJob> job = std::make_shared<CommitJob>();
+        /// Interned here on the submitting thread, the workers never touch the key table
+        job->entity_key = EntityKeyTable::GetInstance().intern(entity_key);
+        job->descriptor = descriptor;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_waiting.push_back(job);
+            m_submitted.push_back(job);
+        }
+        m_condition.notify_one();
+    }
+
+    void GeometryCommitPipeline::worker_loop()
+    {
+        for(;;)
+        {
+            std::shared_ptr<CommitJob> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this] { return m_stop || !m_waiting.empty(); });
+                if(m_stop) return;
+                job = m_waiting.front();
+                m_waiting.pop_front();
+            }
+
+            prepare(*job);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            job->ready = true;
+        }
+    }
+
+    /// @brief Validation and packing, no GL calls
+    void GeometryCommitPipeline::prepare(CommitJob& job)
+    {
+        try
+        {
+            job.descriptor->isValid();
+            std::shared_ptr<VertexArrayObject> staged_vao = std::make_shared<VertexArrayObject>();
+            staged_vao->stage(job.descriptor.get());
+            job.staged_vao = staged_vao;
+        }
+        catch(const std::exception& e)
+        {
+            job.error = e.what();
+        }
+    }
+
+    size_t GeometryCommitPipeline::flush(Gp_gui_scene& scene, const double& budget_ms)
+    {
+        const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        size_t committed = 0;
+
+        for(;;)
+        {
+            std::shared_ptr<CommitJob> job;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if(m_submitted.empty() || !m_submitted.front()->ready) break;
+                job = m_submitted.front();
+                m_submitted.pop_front();
+            }
+
+            if(!job->error.empty())
+            {
+                std::cerr << "Commit of " << EntityKeyTable::GetInstance().str(job->entity_key) << " failed : " << job->error << '\n';
+            }
+            else
+            {
+                Gp_gui_entity_handle entity = scene.get_entity(job->entity_key);
+                entity.GetComponent<OpenGL_3_3_RenderKernel>()->set_geometry_descriptor(job->descriptor, job->staged_vao);
+                ++committed;
+            }
+
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+            if(elapsed.count() >= budget_ms) break;
+        }
+
+        return committed;
+    }
+
+    size_t GeometryCommitPipeline::pending() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_submitted.size();
+    }
+}
@@ -6,7 +6,7 @@
 namespace gridpro_gui
 {
 
-    Gp_gui_entity_handle::Gp_gui_entity_handle() : entity_ptr(nullptr), scene_ptr(nullptr)
+    Gp_gui_entity_handle::Gp_gui_entity_handle() : entity_key(INVALID_ENTITY_KEY), scene_ptr(nullptr)
     {
     
     }
@@ -18,23 +18,53 @@ namespace gridpro_gui
 
     bool Gp_gui_entity_handle::is_valid() const
     {
-        return entity_ptr->is_valid() && scene_ptr != nullptr;
+        ecs::Entity* entity_ptr = entity();
+        return entity_ptr != nullptr && entity_ptr->is_valid();
     }
 
     void Gp_gui_entity_handle::destroy()
     {
-        if(entity_ptr == nullptr || scene_ptr == nullptr)
+        if(entity() == nullptr)
         {
             std::cout << "Entity or Scene is not valid" << std::endl;
             return;
         } 
+        /// The scene destroys the ecs entity and frees its slot
         scene_ptr->remove_entity_from_registry(entity_key);  
-        entity_ptr->destroy();
+    }
+
+    const uint32_t Gp_gui_entity_handle::get_id() const
+    {
+        return entity_slot.slot;
+    }
+
+    void Gp_gui_entity_handle::set_transform(const glm::mat4& local)
+    {
+        if(entity() == nullptr) throw std::runtime_error("Entity is not valid");
+        scene_ptr->Transforms.set_local_transform(entity_slot.slot, local);
+    }
+
+    void Gp_gui_entity_handle::set_parent(const Gp_gui_entity_handle& parent)
+    {
+        if(entity() == nullptr) throw std::runtime_error("Entity is not valid");
+        if(parent.entity() != nullptr && parent.scene_ptr != scene_ptr) throw std::runtime_error("Parent entity belongs to another scene");
+        scene_ptr->Transforms.set_parent(entity_slot.slot, parent.entity() != nullptr ? parent.entity_slot.slot : TransformComponent::NO_PARENT);
+    }
+
+    const glm::mat4& Gp_gui_entity_handle::get_world_matrix() const
+    {
+        static const glm::mat4 identity(1.0f);
+        return entity() != nullptr ? scene_ptr->Transforms.get_world_matrix(entity_slot.slot) : identity;
+    }
+
+    ecs::Entity* Gp_gui_entity_handle::entity() const
+    {
+        return scene_ptr != nullptr ? scene_ptr->Entity_DataBase.get(entity_slot) : nullptr;
     }
 
     const std::string& Gp_gui_entity_handle::get_key() const
     {
-        return entity_key;
+        return EntityKeyTable::GetInstance().str(entity_key);
     }
 
 
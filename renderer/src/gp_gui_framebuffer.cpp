@@ -1,32 +1,586 @@
 #include "gp_gui_framebuffer.h"
+#include "xsimd/xsimd.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace gridpro_gui 
 {
 
+  namespace
+  {
+    /// @brief Index of the lowest set bit (bits != 0)
+    inline uint32_t count_trailing_zeros(const uint64_t bits)
+    {
+#ifdef _MSC_VER
+      unsigned long index;
+      _BitScanForward64(&index, bits);
+      return static_cast<uint32_t>(index);
+#else
+      return static_cast<uint32_t>(__builtin_ctzll(bits));
+#endif
+    }
+  }
+
   /// @brief Constructor
  framebuffer::framebuffer() 
+ : roi_enabled(false), roi_requested(false), pick_pass_open(false), roi_width(GL_PICK_ROI_SIZE), roi_height(GL_PICK_ROI_SIZE),
+   roi_cursor_x(0), roi_cursor_y(0), id_fbo(0), id_color_renderbuffer(0), id_depth_renderbuffer(0), id_fbo_width(0), id_fbo_height(0),
+   previous_draw_fbo(0), previous_read_fbo(0), image_integer_ids(false), peel_layers(1), peel_layer(0), peeled_layer_count(0),
+   peel_depth_textures{0, 0}, peel_texture_width(0), peel_texture_height(0), readback_latency(GL_PICK_READBACK_LATENCY), image_latency(0), frame_counter(0),
+   pass_vp(1.0f), image_vp(1.0f), image_inverse_vp(1.0f),
+   framebufferWidth(0), framebufferHeight(0), framebufferX(0), framebufferY(0), viewportHeight(0), viewportX(0), viewportY(0), viewportWidth(0), color_id(0), last_hit_x(0), last_hit_y(0)
  {
      scan_mode = ScanMode::LEFT_RIGHT; 
+#ifdef _ENABLE_ASYNC_PICK_READBACK_
+     readback_mode = ReadbackMode::ASYNCHRONOUS;
+#else
+     readback_mode = ReadbackMode::SYNCHRONOUS;
+#endif
+#ifdef _ENABLE_INTEGER_PICK_BUFFER_
+     requested_pick_target = PickTarget::INTEGER_ID_FBO;
+#else
+     requested_pick_target = PickTarget::RGB_BACK_BUFFER;
+#endif
+     pick_target = requested_pick_target;
  }
  
- /// @brief Destructor
+ /// @brief Destructor (the pixel pack ring is released with release(), the context is gone by now)
  framebuffer::~framebuffer() {}
 
  /// @brief Update the current framebuffer data
  void framebuffer::update_current_frame_buffer()
+ {
+   if(!pick_pass_open) read_region = compute_read_region();
+
+   /// The ids are read from the offscreen attachment, the caller's framebuffer bindings are restored afterwards
+   if(uses_integer_ids())
+   {
+     if(!pick_pass_open)
+     {
+       Renderer::GL_API()->glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous_draw_fbo);
+       Renderer::GL_API()->glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous_read_fbo);
+     }
+     Renderer::GL_API()->glBindFramebuffer(GL_READ_FRAMEBUFFER, id_fbo);
+   }
+
+   ++frame_counter;
+   if(pick_pass_open && pick_layer_count() > 1)
+   {
+     /// Every layer was read by end_peel_layer, the front most one becomes the pick image
+     set_image_region(peel_region);
+     image_integer_ids = true;
+     framebufferData.resize(static_cast<size_t>(peel_region.width) * peel_region.height * 4);
+     DepthBufferData.resize(framebufferData.size() / 4);
+     std::memcpy(framebufferData.data(), peeled_ids[0].data(), framebufferData.size());
+     std::memcpy(DepthBufferData.data(), peeled_depths[0].data(), DepthBufferData.size() * sizeof(float));
+     set_image_view_projection(pass_vp);
+     image_latency = 0;
+
+     /// The id framebuffer gets its depth renderbuffer back for single layer passes
+     Renderer::GL_API()->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, id_fbo);
+     Renderer::GL_API()->glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, id_depth_renderbuffer);
+     Renderer::GL_API()->glActiveTexture(GL_TEXTURE0 + GL_PICK_PEEL_DEPTH_TEXTURE_UNIT);
+     Renderer::GL_API()->glBindTexture(GL_TEXTURE_2D, 0);
+     Renderer::GL_API()->glActiveTexture(GL_TEXTURE0);
+     peel_layer = 0;
+   }
+   else if(readback_mode == ReadbackMode::ASYNCHRONOUS) read_asynchronous();
+   else                                                 read_synchronous();
+
+   if(pick_pass_open && roi_enabled) Renderer::GL_API()->glDisable(GL_SCISSOR_TEST);
+   if(uses_integer_ids())
+   {
+     Renderer::GL_API()->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previous_draw_fbo);
+     Renderer::GL_API()->glBindFramebuffer(GL_READ_FRAMEBUFFER, previous_read_fbo);
+   }
+   pick_pass_open = false;
+ }
+
+ void framebuffer::begin_pick_pass(const glm::mat4& view_projection)
+ {
+   pass_vp        = view_projection;
+   pick_target    = requested_pick_target;
+   read_region    = compute_read_region();
+   pick_pass_open = true;
+
+   /// Fragments outside the region are never read, so they are not shaded either
+   if(roi_enabled)
+   {
+     Renderer::GL_API()->glEnable(GL_SCISSOR_TEST);
+     Renderer::GL_API()->glScissor(read_region.x, read_region.y, read_region.width, read_region.height);
+   }
+
+   /// The pick pass draws into the offscreen id framebuffer (cleared to id 0 = no hit, inside the scissor only)
+   if(uses_integer_ids())
+   {
+     ensure_id_framebuffer(read_region.x + read_region.width, read_region.y + read_region.height);
+     Renderer::GL_API()->glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous_draw_fbo);
+     Renderer::GL_API()->glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous_read_fbo);
+     Renderer::GL_API()->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, id_fbo);
+
+     const GLuint  no_hit[4]   = {0, 0, 0, 0};
+     const GLfloat far_depth   = 1.0f;
+     Renderer::GL_API()->glClearBufferuiv(GL_COLOR, 0, no_hit);
+     Renderer::GL_API()->glClearBufferfv(GL_DEPTH, 0, &far_depth);
+   }
+ }
+
+ /// @brief The id framebuffer covers the viewport (sized to its far corner so window coordinates are shared)
+ void framebuffer::ensure_id_framebuffer(const uint32_t width, const uint32_t height)
+ {
+   if(id_fbo != 0 && width <= id_fbo_width && height <= id_fbo_height) return;
+   /// Rebuilt on resize (grows to the new viewport, a smaller viewport keeps the larger attachments)
+   const uint32_t fbo_width  = std::max(width,  id_fbo_width);
+   const uint32_t fbo_height = std::max(height, id_fbo_height);
+   release_id_framebuffer();
+
+   GLint previous_fbo = 0;
+   Renderer::GL_API()->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_fbo);
+
+   Renderer::GL_API()->glGenRenderbuffers(1, &id_color_renderbuffer);
+   Renderer::GL_API()->glBindRenderbuffer(GL_RENDERBUFFER, id_color_renderbuffer);
+   Renderer::GL_API()->glRenderbufferStorage(GL_RENDERBUFFER, GL_R32UI, fbo_width, fbo_height);
+
+   Renderer::GL_API()->glGenRenderbuffers(1, &id_depth_renderbuffer);
+   Renderer::GL_API()->glBindRenderbuffer(GL_RENDERBUFFER, id_depth_renderbuffer);
+   Renderer::GL_API()->glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, fbo_width, fbo_height);
+   Renderer::GL_API()->glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+   Renderer::GL_API()->glGenFramebuffers(1, &id_fbo);
+   Renderer::GL_API()->glBindFramebuffer(GL_FRAMEBUFFER, id_fbo);
+   Renderer::GL_API()->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, id_color_renderbuffer);
+   Renderer::GL_API()->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, id_depth_renderbuffer);
+   const GLenum status = Renderer::GL_API()->glCheckFramebufferStatus(GL_FRAMEBUFFER);
+   Renderer::GL_API()->glBindFramebuffer(GL_FRAMEBUFFER, previous_fbo);
+
+   if(status != GL_FRAMEBUFFER_COMPLETE)
+   {
+     release_id_framebuffer();
+     throw std::runtime_error("framebuffer : the R32UI pick framebuffer is incomplete");
+   }
+   id_fbo_width  = fbo_width;
+   id_fbo_height = fbo_height;
+ }
+
+ void framebuffer::set_depth_peel_layers(const uint32_t layers)
+ {
+   peel_layers = std::max<uint32_t>(1, std::min<uint32_t>(layers, GL_PICK_MAX_PEEL_LAYERS));
+ }
+
+ /// @brief Layer 0 renders against a cleared depth texture, layer n against the other texture of the pair while sampling layer n - 1
+ void framebuffer::begin_peel_layer(const uint32_t layer)
+ {
+   if(pick_layer_count() <= 1) return;
+   if(layer == 0)
+   {
+     ensure_peel_depth_textures();
+     peel_region = read_region;
+     peeled_layer_count = 0;
+     peeled_ids.resize(peel_layers);
+     peeled_depths.resize(peel_layers);
+   }
+   peel_layer = layer;
+
+   Renderer::GL_API()->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, id_fbo);
+   Renderer::GL_API()->glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, peel_depth_textures[layer % 2], 0);
+   Renderer::GL_API()->glActiveTexture(GL_TEXTURE0 + GL_PICK_PEEL_DEPTH_TEXTURE_UNIT);
+   Renderer::GL_API()->glBindTexture(GL_TEXTURE_2D, layer > 0 ? peel_depth_textures[(layer + 1) % 2] : 0);
+   Renderer::GL_API()->glActiveTexture(GL_TEXTURE0);
+
+   const GLuint  no_hit[4]  = {0, 0, 0, 0};
+   const GLfloat far_depth  = 1.0f;
+   Renderer::GL_API()->glClearBufferuiv(GL_COLOR, 0, no_hit);
+   Renderer::GL_API()->glClearBufferfv(GL_DEPTH, 0, &far_depth);
+ }
+
+ const bool framebuffer::end_peel_layer(const uint32_t layer)
+ {
+   if(pick_layer_count() <= 1) return false;
+
+   const size_t pixels = static_cast<size_t>(peel_region.width) * peel_region.height;
+   std::vector<uint32_t>& ids    = peeled_ids[layer];
+   std::vector<float>&    depths = peeled_depths[layer];
+   ids.resize(pixels);
+   depths.resize(pixels);
+
+   Renderer::GL_API()->glBindFramebuffer(GL_READ_FRAMEBUFFER, id_fbo);
+   Renderer::GL_API()->glReadBuffer(GL_COLOR_ATTACHMENT0);
+   Renderer::GL_API()->glReadPixels(peel_region.x, peel_region.y, peel_region.width, peel_region.height, GL_RED_INTEGER, GL_UNSIGNED_INT, ids.data());
+   Renderer::GL_API()->glReadPixels(peel_region.x, peel_region.y, peel_region.width, peel_region.height, GL_DEPTH_COMPONENT, GL_FLOAT, depths.data());
+
+   peeled_layer_count = layer + 1;
+   return std::any_of(ids.begin(), ids.end(), [](const uint32_t id) { return id != 0; });
+ }
+
+ /// @brief Depth textures of the id framebuffer's size (sampled with texelFetch, no filtering or comparison)
+ void framebuffer::ensure_peel_depth_textures()
+ {
+   if(peel_depth_textures[0] != 0 && peel_texture_width == id_fbo_width && peel_texture_height == id_fbo_height) return;
+   release_peel_depth_textures();
+
+   Renderer::GL_API()->glGenTextures(2, peel_depth_textures);
+   for(const GLuint texture : peel_depth_textures)
+   {
+     Renderer::GL_API()->glBindTexture(GL_TEXTURE_2D, texture);
+     Renderer::GL_API()->glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, id_fbo_width, id_fbo_height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+     Renderer::GL_API()->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+     Renderer::GL_API()->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+     Renderer::GL_API()->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+   }
+   Renderer::GL_API()->glBindTexture(GL_TEXTURE_2D, 0);
+   peel_texture_width  = id_fbo_width;
+   peel_texture_height = id_fbo_height;
+ }
+
+ void framebuffer::release_peel_depth_textures()
+ {
+   if(peel_depth_textures[0] != 0) Renderer::GL_API()->glDeleteTextures(2, peel_depth_textures);
+   peel_depth_textures[0] = peel_depth_textures[1] = 0;
+   peel_texture_width = peel_texture_height = 0;
+ }
+
+ int64_t framebuffer::peel_index(const float current_mouse_x, const float current_mouse_y) const
+ {
+   const int64_t pixelX = static_cast<int64_t>(current_mouse_x) - peel_region.x;
+   const int64_t pixelY = static_cast<int64_t>(peel_region.viewport_height) - static_cast<int64_t>(current_mouse_y) - 1 - peel_region.y;
+   if (pixelX >= 0 && pixelX < peel_region.width && pixelY >= 0 && pixelY < peel_region.height)
+     return pixelY * peel_region.width + pixelX;
+   return -1;
+ }
+
+ /// @brief Layers are front to back per pixel, so the stack is already ordered
+ std::vector<framebuffer::LayerHit> framebuffer::id_stack_at(const float current_mouse_x, const float current_mouse_y) const
+ {
+   std::vector<LayerHit> stack;
+   const int64_t index = peel_index(current_mouse_x, current_mouse_y);
+   if(index < 0) return stack;
+   for(uint32_t layer = 0; layer < peeled_layer_count; ++layer)
+     if(peeled_ids[layer][index] != 0) stack.push_back(LayerHit{peeled_ids[layer][index], peeled_depths[layer][index]});
+   return stack;
+ }
+
+ std::vector<framebuffer::LayerHit> framebuffer::id_stack_in_rectangle(const float x0, const float y0, const float x1, const float y1) const
+ {
+   std::vector<LayerHit> stack;
+   if(peeled_layer_count == 0) return stack;
+
+   const int64_t col_begin = std::max<int64_t>(0, static_cast<int64_t>(std::min(x0, x1)) - peel_region.x);
+   const int64_t col_end   = std::min<int64_t>(peel_region.width, static_cast<int64_t>(std::max(x0, x1)) - peel_region.x + 1);
+   const int64_t row_begin = std::max<int64_t>(0, static_cast<int64_t>(peel_region.viewport_height) - static_cast<int64_t>(std::max(y0, y1)) - 1 - peel_region.y);
+   const int64_t row_end   = std::min<int64_t>(peel_region.height, static_cast<int64_t>(peel_region.viewport_height) - static_cast<int64_t>(std::min(y0, y1)) - peel_region.y);
+
+   /// Nearest depth of every id, a run of the same id along a row reuses its map entry
+   std::unordered_map<uint32_t, float> nearest;
+   for(uint32_t layer = 0; layer < peeled_layer_count; ++layer)
+     for(int64_t row = row_begin; row < row_end; ++row)
+     {
+       uint32_t last = 0;
+       std::unordered_map<uint32_t, float>::iterator it = nearest.end();
+       for(int64_t col = col_begin; col < col_end; ++col)
+       {
+         const size_t   index = row * peel_region.width + col;
+         const uint32_t id    = peeled_ids[layer][index];
+         const float    depth = peeled_depths[layer][index];
+         if(id == 0) continue;
+         if(id != last) { it = nearest.emplace(id, depth).first; last = id; }
+         if(depth < it->second) it->second = depth;
+       }
+     }
+
+   stack.reserve(nearest.size());
+   for(const std::pair<const uint32_t, float>& hit : nearest) stack.push_back(LayerHit{hit.first, hit.second});
+   std::sort(stack.begin(), stack.end(), [](const LayerHit& a, const LayerHit& b) { return a.depth < b.depth || (a.depth == b.depth && a.id < b.id); });
+   return stack;
+ }
+
+ void framebuffer::release_id_framebuffer()
+ {
+   if(id_fbo != 0)                Renderer::GL_API()->glDeleteFramebuffers(1, &id_fbo);
+   if(id_color_renderbuffer != 0) Renderer::GL_API()->glDeleteRenderbuffers(1, &id_color_renderbuffer);
+   if(id_depth_renderbuffer != 0) Renderer::GL_API()->glDeleteRenderbuffers(1, &id_depth_renderbuffer);
+   id_fbo = id_color_renderbuffer = id_depth_renderbuffer = 0;
+   id_fbo_width = id_fbo_height = 0;
+ }
+
+ /// @brief RGBA8 for the back buffer, the single 32 bit channel of the id attachment otherwise (both 4 bytes per pixel)
+ void framebuffer::pixel_read_format(GLenum& format, GLenum& type) const
+ {
+   format = uses_integer_ids() ? GL_RED_INTEGER : GL_RGBA;
+   type   = uses_integer_ids() ? GL_UNSIGNED_INT : GL_UNSIGNED_BYTE;
+ }
+
+ void framebuffer::set_region_of_interest_size(const uint32_t width, const uint32_t height)
+ {
+   roi_width  = std::max<uint32_t>(1, width);
+   roi_height = std::max<uint32_t>(1, height);
+ }
+
+ void framebuffer::request_region_of_interest(const float current_mouse_x, const float current_mouse_y)
+ {
+   roi_cursor_x  = current_mouse_x;
+   roi_cursor_y  = current_mouse_y;
+   roi_requested = true;
+ }
+
+ /// @brief The whole viewport, or the region of interest around the cursor clamped to the viewport
+ framebuffer::PickRegion framebuffer::compute_read_region() const
  {
    GLint viewport[4];
-   glGetIntegerv(GL_VIEWPORT , viewport);
-   glReadBuffer(GL_BACK);
-   framebufferWidth  = viewport[2];
-   framebufferHeight = viewport[3];
+   Renderer::GL_API()->glGetIntegerv(GL_VIEWPORT, viewport);
+
+   PickRegion region;
+   region.x = viewport[0];
+   region.y = viewport[1];
+   region.width  = viewport[2];
+   region.height = viewport[3];
+   region.viewport_height = viewport[3];
+   region.viewport_x      = viewport[0];
+   region.viewport_y      = viewport[1];
+   region.viewport_width  = viewport[2];
+   if(!roi_enabled || !roi_requested) return region;
+
+   /// Same cursor convention as image_index() : window pixels with y from the top, centred relative to the viewport origin
+   const int32_t center_x = static_cast<int32_t>(roi_cursor_x) - viewport[0];
+   const int32_t center_y = static_cast<int32_t>(viewport[3]) - static_cast<int32_t>(roi_cursor_y) - 1 - viewport[1];
+   const int32_t width    = std::min<int32_t>(roi_width,  viewport[2]);
+   const int32_t height   = std::min<int32_t>(roi_height, viewport[3]);
+
+   region.x = viewport[0] + std::max<int32_t>(0, std::min<int32_t>(center_x - width  / 2, viewport[2] - width));
+   region.y = viewport[1] + std::max<int32_t>(0, std::min<int32_t>(center_y - height / 2, viewport[3] - height));
+   region.width  = width;
+   region.height = height;
+   return region;
+ }
+
+ void framebuffer::set_image_region(const PickRegion& region)
+ {
+   framebufferWidth  = region.width;
+   framebufferHeight = region.height;
+   framebufferX      = region.x;
+   framebufferY      = region.y;
+   viewportHeight    = region.viewport_height;
+   viewportX         = region.viewport_x;
+   viewportY         = region.viewport_y;
+   viewportWidth     = region.viewport_width;
+ }
+
+ int64_t framebuffer::image_index(const float current_mouse_x, const float current_mouse_y) const
+ {
+   const int64_t pixelX = static_cast<int64_t>(current_mouse_x) - framebufferX;
+   const int64_t pixelY = static_cast<int64_t>(viewportHeight) - static_cast<int64_t>(current_mouse_y) - 1 - framebufferY;
+   if (pixelX >= 0 && pixelX < framebufferWidth && pixelY >= 0 && pixelY < framebufferHeight)
+     return pixelY * framebufferWidth + pixelX;
+   return -1;
+ }
+
+ void framebuffer::set_readback_mode(const ReadbackMode mode)
+ {
+   readback_mode = mode;
+ }
+
+ void framebuffer::set_readback_latency(const uint32_t frames)
+ {
+   readback_latency = std::max<uint32_t>(1, std::min<uint32_t>(frames, GL_PICK_READBACK_MAX_LATENCY));
+ }
+
+ /// @brief Delete the pixel pack ring and the offscreen pick framebuffer
+ void framebuffer::release()
+ {
+   release_pixel_pack_ring();
+   release_id_framebuffer();
+   release_peel_depth_textures();
+ }
+
+ /// @brief Delete the pixel pack buffers and the pending fences
+ void framebuffer::release_pixel_pack_ring()
+ {
+   for(PixelPackSlot& slot : pixel_pack_ring)
+   {
+     if(slot.fence != nullptr) Renderer::GL_API()->glDeleteSync(slot.fence);
+     if(slot.color_pbo != 0)   Renderer::GL_API()->glDeleteBuffers(1, &slot.color_pbo);
+     if(slot.depth_pbo != 0)   Renderer::GL_API()->glDeleteBuffers(1, &slot.depth_pbo);
+   }
+   pixel_pack_ring.clear();
+ }
+
+ /// @brief Blocking read of this frame's color and depth images
+ void framebuffer::read_synchronous()
+ {
+   GLenum format, type;
+   pixel_read_format(format, type);
+   glReadBuffer(uses_integer_ids() ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+   set_image_region(read_region);
+   image_integer_ids = uses_integer_ids();
    //framebufferData.clear();
    framebufferData.resize(framebufferWidth * framebufferHeight * 4);
    //DepthBufferData.clear();
    DepthBufferData.resize(framebufferData.size()/4);
-   glReadPixels(0, 0, framebufferWidth, framebufferHeight, GL_RGBA, GL_UNSIGNED_BYTE, framebufferData.data());
-   glReadPixels(0, 0, framebufferWidth, framebufferHeight, GL_DEPTH_COMPONENT, GL_FLOAT, DepthBufferData.data());
-   
+   glReadPixels(framebufferX, framebufferY, framebufferWidth, framebufferHeight, format, type, framebufferData.data());
+   glReadPixels(framebufferX, framebufferY, framebufferWidth, framebufferHeight, GL_DEPTH_COMPONENT, GL_FLOAT, DepthBufferData.data());
+   set_image_view_projection(pass_vp);
+   image_latency = 0;
+ }
+
+ /// @brief Start this frame's readback into the ring and pick up the newest finished one
+ /// The ring has latency + 1 slots : the slot written now held the frame that is latency + 1 frames old,
+ /// so the oldest pending readback is consumed (waiting if needed) before the ring laps it.
+ void framebuffer::read_asynchronous()
+ {
+   const size_t ring_size = readback_latency + 1;
+   if(pixel_pack_ring.size() != ring_size)
+   {
+     release_pixel_pack_ring();
+     pixel_pack_ring.resize(ring_size);
+   }
+
+   PixelPackSlot& current = pixel_pack_ring[frame_counter % ring_size];
+   if(current.fence != nullptr) consume_readback(current, true);
+   issue_readback(current);
+
+   /// Newest finished readback other than the one just issued
+   for(uint64_t age = 1; age < ring_size && age < frame_counter; ++age)
+   {
+     PixelPackSlot& slot = pixel_pack_ring[(frame_counter - age) % ring_size];
+     if(slot.fence == nullptr) continue;
+
+     const GLenum status = Renderer::GL_API()->glClientWaitSync(slot.fence, 0, 0);
+     const bool   oldest = (age == ring_size - 1);
+     if(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || oldest)
+     {
+       consume_readback(slot, oldest);
+       /// Anything older than the consumed image is stale
+       for(uint64_t older = age + 1; older < ring_size && older < frame_counter; ++older)
+       {
+         PixelPackSlot& stale = pixel_pack_ring[(frame_counter - older) % ring_size];
+         if(stale.fence != nullptr) { Renderer::GL_API()->glDeleteSync(stale.fence); stale.fence = nullptr; }
+       }
+       break;
+     }
+   }
+ }
+
+ /// @brief Pick up the newest finished readback without issuing a new one (frames where the pick pass is skipped)
+ void framebuffer::poll_pending_readbacks()
+ {
+   PixelPackSlot* newest = nullptr;
+   for(PixelPackSlot& slot : pixel_pack_ring)
+   {
+     if(slot.fence == nullptr || (newest != nullptr && slot.frame < newest->frame)) continue;
+     const GLenum status = Renderer::GL_API()->glClientWaitSync(slot.fence, 0, 0);
+     if(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) newest = &slot;
+   }
+   if(newest == nullptr) return;
+
+   const uint64_t consumed_frame = newest->frame;
+   consume_readback(*newest, false);
+   for(PixelPackSlot& stale : pixel_pack_ring)
+     if(stale.fence != nullptr && stale.frame < consumed_frame) { Renderer::GL_API()->glDeleteSync(stale.fence); stale.fence = nullptr; }
+ }
+
+ /// @brief Hash of the pick region (viewport or region of interest), pick target and peel layers of the next pass
+ const uint64_t framebuffer::pick_pass_signature() const
+ {
+   const PickRegion region = compute_read_region();
+   const uint64_t fields[] = { static_cast<uint64_t>(static_cast<uint32_t>(region.x)), static_cast<uint64_t>(static_cast<uint32_t>(region.y)),
+                               region.width, region.height, region.viewport_height, static_cast<uint64_t>(requested_pick_target), peel_layers };
+   uint64_t signature = 14695981039346656037ull;
+   for(const uint64_t field : fields)
+     signature = (signature ^ field) * 1099511628211ull;
+   return signature;
+ }
+
+ /// @brief Queue glReadPixels of the color and depth images into the slot's pixel pack buffers
+ void framebuffer::issue_readback(PixelPackSlot& slot)
+ {
+   const PickRegion& region = read_region;
+   const GLsizeiptr pixels = static_cast<GLsizeiptr>(region.width) * region.height;
+
+   if(slot.color_pbo == 0)
+   {
+     Renderer::GL_API()->glGenBuffers(1, &slot.color_pbo);
+     Renderer::GL_API()->glGenBuffers(1, &slot.depth_pbo);
+   }
+
+   /// Storage only grows (a moving region of interest keeps its size, a resized viewport reallocates once)
+   const bool grow = (pixels > slot.capacity);
+
+   GLenum format, type;
+   pixel_read_format(format, type);
+   Renderer::GL_API()->glReadBuffer(uses_integer_ids() ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+   Renderer::GL_API()->glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.color_pbo);
+   if(grow) Renderer::GL_API()->glBufferData(GL_PIXEL_PACK_BUFFER, pixels * 4, nullptr, GL_STREAM_READ);
+   Renderer::GL_API()->glReadPixels(region.x, region.y, region.width, region.height, format, type, nullptr);
+
+   Renderer::GL_API()->glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.depth_pbo);
+   if(grow) Renderer::GL_API()->glBufferData(GL_PIXEL_PACK_BUFFER, pixels * sizeof(float), nullptr, GL_STREAM_READ);
+   Renderer::GL_API()->glReadPixels(region.x, region.y, region.width, region.height, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+   Renderer::GL_API()->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+   if(grow) slot.capacity = pixels;
+   slot.region = region;
+   slot.integer_ids = uses_integer_ids();
+   slot.frame  = frame_counter;
+   slot.view_projection = pass_vp;
+   slot.fence  = Renderer::GL_API()->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+ }
+
+ /// @brief Copy a finished readback into the pick image (blocking waits for the GPU if it is not finished yet)
+ void framebuffer::consume_readback(PixelPackSlot& slot, const bool blocking)
+ {
+   const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+   GLenum result = Renderer::GL_API()->glClientWaitSync(slot.fence, 0, 0);
+   const bool stalled = (result == GL_TIMEOUT_EXPIRED);
+   while(blocking && result == GL_TIMEOUT_EXPIRED)
+     result = Renderer::GL_API()->glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_STREAMING_FENCE_TIMEOUT_NS);
+
+   const std::chrono::nanoseconds waited = std::chrono::high_resolution_clock::now() - start;
+   readback_statistics.record_wait(waited.count() / 1.0e6, stalled);
+
+   Renderer::GL_API()->glDeleteSync(slot.fence);
+   slot.fence = nullptr;
+   if(result == GL_WAIT_FAILED || result == GL_TIMEOUT_EXPIRED) { std::cerr << "framebuffer : pick readback fence wait failed\n"; return; }
+
+   const size_t pixels = static_cast<size_t>(slot.region.width) * slot.region.height;
+   set_image_region(slot.region);
+   image_integer_ids = slot.integer_ids;
+   framebufferData.resize(pixels * 4);
+   DepthBufferData.resize(pixels);
+
+   Renderer::GL_API()->glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.color_pbo);
+   if(const void* mapped = Renderer::GL_API()->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, pixels * 4, GL_MAP_READ_BIT))
+   {
+     std::memcpy(framebufferData.data(), mapped, pixels * 4);
+     Renderer::GL_API()->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+   }
+   Renderer::GL_API()->glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.depth_pbo);
+   if(const void* mapped = Renderer::GL_API()->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, pixels * sizeof(float), GL_MAP_READ_BIT))
+   {
+     std::memcpy(DepthBufferData.data(), mapped, pixels * sizeof(float));
+     Renderer::GL_API()->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+   }
+   Renderer::GL_API()->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+   readback_statistics.record_bytes(pixels * (4 + sizeof(float)));
+   set_image_view_projection(slot.view_projection);
+   image_latency = static_cast<uint32_t>(frame_counter - slot.frame);
+ }
+
+ /// @brief The inverse is only recomputed when the camera moved between the passes
+ void framebuffer::set_image_view_projection(const glm::mat4& view_projection)
+ {
+   if(view_projection == image_vp) return;
+   image_vp         = view_projection;
+   image_inverse_vp = glm::inverse(view_projection);
  }
 
  /// @brief Get the color id at the specified mouse coordinates
@@ -87,7 +641,7 @@ int segment_passed = 0;
 for (int i = 0; i < pick_matrix_length; ++i) {
     for (int j = 0; j < pick_matrix_width; ++j) {
         // Ensure the current coordinates are within the bounds of your matrix
-        if (x >= 0 && x < framebufferWidth && y >= 0 && y < framebufferHeight) {
+        if (image_index(x, y) >= 0) {
             uint32_t hit = pixel_at(x, y);
             if (hit != 0) {
                 /*DEBUG_PRINT("Hit at", x, y, "Pixel ID =", hit);*/
@@ -161,32 +715,269 @@ std::vector<uint32_t> framebuffer::pick_matrix(const float current_mouse_x, cons
  /// @brief Get the depth at the specified mouse coordinates
  float framebuffer::depth_at(const float current_mouse_x, const float current_mouse_y)
  {
-    // Calculate the pixel coordinates in the framebuffer
-   int pixelX = static_cast<int>(current_mouse_x);
-   int pixelY = framebufferHeight - static_cast<int>(current_mouse_y) - 1;
-   if (pixelX >= 0 && pixelX < framebufferWidth && pixelY >= 0 && pixelY < framebufferHeight) {
-            // Calculate the index in the DepthBuffer data array
-            int index = (pixelY * framebufferWidth + pixelX); 
+    // Calculate the index in the DepthBuffer data array (the image may only cover the region of interest)
+   const int64_t index = image_index(current_mouse_x, current_mouse_y);
+   if (index >= 0) {
             return DepthBufferData[index];
         }
       return 0;
  }
  
+ /// @brief Rectangle selection over the pick image
+ std::vector<uint32_t> framebuffer::ids_in_rectangle(const float x0, const float y0, const float x1, const float y1, const uint32_t id_begin, const uint32_t id_end)
+ {
+   std::vector<uint32_t> ids;
+   if(id_end <= id_begin || framebufferWidth == 0 || framebufferHeight == 0) return ids;
+   std::vector<uint64_t> id_bits((id_end - id_begin + 63) / 64, 0);
+
+   /// Image columns / rows covered by the rectangle (rows grow upwards, cursor y downwards)
+   const int64_t col_begin = std::max<int64_t>(0, static_cast<int64_t>(std::min(x0, x1)) - framebufferX);
+   const int64_t col_end   = std::min<int64_t>(framebufferWidth, static_cast<int64_t>(std::max(x0, x1)) - framebufferX + 1);
+   const int64_t row_begin = std::max<int64_t>(0, image_row(std::max(y0, y1)));
+   const int64_t row_end   = std::min<int64_t>(framebufferHeight, image_row(std::min(y0, y1)) + 1);
+
+   for(int64_t row = row_begin; row < row_end && col_begin < col_end; ++row)
+     scan_id_span(row * framebufferWidth + col_begin, col_end - col_begin, id_begin, id_end, id_bits);
+
+   return collect_id_bits(id_bits, id_begin);
+ }
+
+ /// @brief Lasso selection over the pick image (scanline fill of the polygon, sampled at pixel centers)
+ std::vector<uint32_t> framebuffer::ids_in_lasso(const std::vector<glm::vec2>& lasso, const uint32_t id_begin, const uint32_t id_end)
+ {
+   std::vector<uint32_t> ids;
+   if(lasso.size() < 3 || id_end <= id_begin || framebufferWidth == 0 || framebufferHeight == 0) return ids;
+   std::vector<uint64_t> id_bits((id_end - id_begin + 63) / 64, 0);
+
+   float min_y = lasso[0].y, max_y = lasso[0].y;
+   for(const glm::vec2& point : lasso) { min_y = std::min(min_y, point.y); max_y = std::max(max_y, point.y); }
+
+   std::vector<float> crossings;
+   for(int64_t cursor_y = static_cast<int64_t>(min_y); cursor_y <= static_cast<int64_t>(max_y); ++cursor_y)
+   {
+     const int64_t row = image_row(static_cast<float>(cursor_y));
+     if(row < 0 || row >= framebufferHeight) continue;
+
+     /// x of the polygon edges crossing the pixel center line
+     const float center_y = cursor_y + 0.5f;
+     crossings.clear();
+     for(size_t i = 0, j = lasso.size() - 1; i < lasso.size(); j = i++)
+     {
+       const glm::vec2& a = lasso[i];
+       const glm::vec2& b = lasso[j];
+       if((a.y <= center_y) != (b.y <= center_y))
+         crossings.push_back(a.x + (center_y - a.y) * (b.x - a.x) / (b.y - a.y));
+     }
+     std::sort(crossings.begin(), crossings.end());
+
+     /// Pixel centers between each pair of crossings are inside
+     for(size_t k = 0; k + 1 < crossings.size(); k += 2)
+     {
+       const int64_t col_begin = std::max<int64_t>(0, static_cast<int64_t>(std::ceil(crossings[k] - 0.5f)) - framebufferX);
+       const int64_t col_end   = std::min<int64_t>(framebufferWidth, static_cast<int64_t>(std::floor(crossings[k + 1] - 0.5f)) - framebufferX + 1);
+       if(col_begin < col_end) scan_id_span(row * framebufferWidth + col_begin, col_end - col_begin, id_begin, id_end, id_bits);
+     }
+   }
+
+   return collect_id_bits(id_bits, id_begin);
+ }
+
+ std::vector<uint32_t> framebuffer::collect_id_bits(const std::vector<uint64_t>& id_bits, const uint32_t id_begin)
+ {
+   std::vector<uint32_t> ids;
+   for(size_t word = 0; word < id_bits.size(); ++word)
+     for(uint64_t bits = id_bits[word]; bits != 0; bits &= bits - 1)
+       ids.push_back(id_begin + static_cast<uint32_t>(word * 64 + count_trailing_zeros(bits)));
+   return ids;
+ }
+
+ /// @brief Both image formats hold one 32 bit word per pixel : the raw id (R32UI) or RGBA with the id in the low 24 bits
+ /// Whole batches of background or of the id seen last are skipped with one SIMD compare, the rest is marked in the bitset
+ void framebuffer::scan_id_span(const size_t first, const size_t count, const uint32_t id_begin, const uint32_t id_end, std::vector<uint64_t>& id_bits) const
+ {
+   const uint32_t* pixels = reinterpret_cast<const uint32_t*>(framebufferData.data()) + first;
+   const uint32_t  mask   = image_integer_ids ? 0xFFFFFFFFu : 0x00FFFFFFu;
+   uint32_t last = 0;
+   size_t   i    = 0;
+
+   auto mark = [&](const uint32_t id)
+   {
+     if(id != last && id >= id_begin && id < id_end)
+       id_bits[(id - id_begin) >> 6] |= uint64_t(1) << ((id - id_begin) & 63);
+     last = id;
+   };
+
+#if !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+   typedef xsimd::batch<uint32_t> id_batch;
+   const id_batch batch_mask(mask);
+   alignas(id_batch::arch_type::alignment()) uint32_t lanes[id_batch::size];
+   for(; i + id_batch::size <= count; i += id_batch::size)
+   {
+     const id_batch batch_ids = id_batch::load_unaligned(pixels + i) & batch_mask;
+     if(xsimd::all(batch_ids == id_batch(last))) continue;
+     batch_ids.store_aligned(lanes);
+     for(size_t lane = 0; lane < id_batch::size; ++lane) mark(lanes[lane]);
+   }
+#endif
+   for(; i < count; ++i) mark(pixels[i] & mask);
+ }
+
+ int64_t framebuffer::image_row(const float current_mouse_y) const
+ {
+   return static_cast<int64_t>(viewportHeight) - static_cast<int64_t>(current_mouse_y) - 1 - framebufferY;
+ }
+
  /// @brief Get the last hit depth
  float framebuffer::last_hit_depth()
  {
    return depth_at(last_hit_x, last_hit_y);
  }
 
+ framebuffer::SurfaceSample framebuffer::surface_at(const float current_mouse_x, const float current_mouse_y, const glm::mat4& inverse_view_projection)
+ {
+   uint32_t width = 0, height = 0;
+   const std::vector<SurfaceSample> samples = surface_in_rectangle(current_mouse_x, current_mouse_y, current_mouse_x, current_mouse_y, inverse_view_projection, width, height);
+   if(!samples.empty()) return samples.front();
+
+   SurfaceSample miss;
+   miss.position = miss.normal = glm::vec3(0.0f);
+   miss.depth = 1.0f;
+   miss.hit   = false;
+   return miss;
+ }
+
+ framebuffer::SurfaceSample framebuffer::last_hit_surface(const glm::mat4& inverse_view_projection)
+ {
+   return surface_at(last_hit_x, last_hit_y, inverse_view_projection);
+ }
+
+ /// @brief Positions of the rectangle plus a one pixel border are unprojected in batch, normals come from the
+ /// neighbour differences, taking on each axis the side with the smaller depth step so silhouettes do not bend them
+ std::vector<framebuffer::SurfaceSample> framebuffer::surface_in_rectangle(const float x0, const float y0, const float x1, const float y1,
+                                                                           const glm::mat4& inverse_view_projection, uint32_t& width, uint32_t& height)
+ {
+   std::vector<SurfaceSample> samples;
+   width = height = 0;
+   if(framebufferWidth == 0 || framebufferHeight == 0 || DepthBufferData.empty()) return samples;
+
+   const int64_t col_begin = std::max<int64_t>(0, static_cast<int64_t>(std::min(x0, x1)) - framebufferX);
+   const int64_t col_end   = std::min<int64_t>(framebufferWidth, static_cast<int64_t>(std::max(x0, x1)) - framebufferX + 1);
+   const int64_t row_begin = std::max<int64_t>(0, image_row(std::max(y0, y1)));
+   const int64_t row_end   = std::min<int64_t>(framebufferHeight, image_row(std::min(y0, y1)) + 1);
+   if(col_begin >= col_end || row_begin >= row_end) return samples;
+
+   /// Unprojected block with the border (structure of arrays, rows bottom up like the image)
+   const int64_t block_col  = std::max<int64_t>(0, col_begin - 1);
+   const int64_t block_row  = std::max<int64_t>(0, row_begin - 1);
+   const int64_t block_cols = std::min<int64_t>(framebufferWidth,  col_end + 1) - block_col;
+   const int64_t block_rows = std::min<int64_t>(framebufferHeight, row_end + 1) - block_row;
+   std::vector<float> px(block_cols * block_rows), py(px.size()), pz(px.size()), pw(px.size());
+   for(int64_t r = 0; r < block_rows; ++r)
+     unproject_span(block_row + r, block_col, block_cols, inverse_view_projection,
+                    &px[r * block_cols], &py[r * block_cols], &pz[r * block_cols], &pw[r * block_cols]);
+
+   width  = static_cast<uint32_t>(col_end - col_begin);
+   height = static_cast<uint32_t>(row_end - row_begin);
+   samples.resize(static_cast<size_t>(width) * height);
+
+   auto position = [&](const int64_t r, const int64_t c) { const size_t i = r * block_cols + c; return glm::vec3(px[i], py[i], pz[i]); };
+   auto depth    = [&](const int64_t r, const int64_t c) { return DepthBufferData[(block_row + r) * framebufferWidth + block_col + c]; };
+   auto covered  = [&](const int64_t r, const int64_t c) { return r >= 0 && r < block_rows && c >= 0 && c < block_cols && pw[r * block_cols + c] > 0.0f; };
+
+   for(int64_t row = row_begin; row < row_end; ++row)
+     for(int64_t col = col_begin; col < col_end; ++col)
+     {
+       const int64_t r = row - block_row, c = col - block_col;
+       SurfaceSample& sample = samples[(row_end - 1 - row) * width + (col - col_begin)];
+       sample.depth    = depth(r, c);
+       sample.hit      = covered(r, c);
+       sample.position = sample.hit ? position(r, c) : glm::vec3(0.0f);
+       sample.normal   = glm::vec3(0.0f);
+       if(!sample.hit) continue;
+
+       /// Differences along +x / +y from the smoother side (forward or backward)
+       const bool right = covered(r, c + 1), left = covered(r, c - 1), up = covered(r + 1, c), down = covered(r - 1, c);
+       if(!(right || left) || !(up || down)) continue;
+       const bool use_right = right && (!left || std::abs(depth(r, c + 1) - sample.depth) <= std::abs(sample.depth - depth(r, c - 1)));
+       const bool use_up    = up    && (!down || std::abs(depth(r + 1, c) - sample.depth) <= std::abs(sample.depth - depth(r - 1, c)));
+       const glm::vec3 dx = use_right ? position(r, c + 1) - sample.position : sample.position - position(r, c - 1);
+       const glm::vec3 dy = use_up    ? position(r + 1, c) - sample.position : sample.position - position(r - 1, c);
+
+       /// Screen x / y steps in a right handed world, so the cross product faces the viewer
+       const glm::vec3 normal = glm::cross(dx, dy);
+       const float length = glm::length(normal);
+       if(length > 0.0f) sample.normal = normal / length;
+     }
+   return samples;
+ }
+
+ /// @brief p = inverse_view_projection * (ndc x, ndc y, 2 depth - 1, 1) / w for a run of pixels, one SIMD batch of pixels at a time
+ void framebuffer::unproject_span(const int64_t row, const int64_t first_col, const size_t count, const glm::mat4& inverse_view_projection,
+                                  float* x, float* y, float* z, float* w) const
+ {
+   const glm::mat4& m = inverse_view_projection;
+   const float* depths = DepthBufferData.data() + row * framebufferWidth + first_col;
+
+   /// ndc x of pixel i is ndc_x0 + i * ndc_dx (pixel centers), ndc y is constant along the row
+   const float ndc_dx = 2.0f / viewportWidth;
+   const float ndc_x0 = 2.0f * (framebufferX + first_col + 0.5f - viewportX) / viewportWidth - 1.0f;
+   const float ndc_y  = 2.0f * (framebufferY + row + 0.5f - viewportY) / viewportHeight - 1.0f;
+
+   size_t i = 0;
+#if !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+   typedef xsimd::batch<float> float_batch;
+   alignas(float_batch::arch_type::alignment()) float lane_offsets[float_batch::size];
+   for(size_t lane = 0; lane < float_batch::size; ++lane) lane_offsets[lane] = static_cast<float>(lane);
+   const float_batch lanes = float_batch::load_aligned(lane_offsets);
+   const float_batch one(1.0f), zero(0.0f);
+
+   for(; i + float_batch::size <= count; i += float_batch::size)
+   {
+     const float_batch depth = float_batch::load_unaligned(depths + i);
+     const float_batch nx = float_batch(ndc_x0 + i * ndc_dx) + lanes * float_batch(ndc_dx);
+     const float_batch nz = depth * float_batch(2.0f) - one;
+
+     /// Column major : row k of the product is m[0][k] nx + m[1][k] ny + m[2][k] nz + m[3][k]
+     const float_batch cw = xsimd::fma(float_batch(m[0][3]), nx, xsimd::fma(float_batch(m[2][3]), nz, float_batch(m[1][3] * ndc_y + m[3][3])));
+     const float_batch cx = xsimd::fma(float_batch(m[0][0]), nx, xsimd::fma(float_batch(m[2][0]), nz, float_batch(m[1][0] * ndc_y + m[3][0])));
+     const float_batch cy = xsimd::fma(float_batch(m[0][1]), nx, xsimd::fma(float_batch(m[2][1]), nz, float_batch(m[1][1] * ndc_y + m[3][1])));
+     const float_batch cz = xsimd::fma(float_batch(m[0][2]), nx, xsimd::fma(float_batch(m[2][2]), nz, float_batch(m[1][2] * ndc_y + m[3][2])));
+
+     /// Background (cleared far depth) and degenerate w are flagged with w = 0
+     const auto valid = (depth < one) && (xsimd::abs(cw) > float_batch(std::numeric_limits<float>::min()));
+     const float_batch inverse_w = xsimd::select(valid, one / cw, zero);
+     (cx * inverse_w).store_unaligned(x + i);
+     (cy * inverse_w).store_unaligned(y + i);
+     (cz * inverse_w).store_unaligned(z + i);
+     xsimd::select(valid, one, zero).store_unaligned(w + i);
+   }
+#endif
+   for(; i < count; ++i)
+   {
+     const glm::vec4 clip = m * glm::vec4(ndc_x0 + i * ndc_dx, ndc_y, depths[i] * 2.0f - 1.0f, 1.0f);
+     const bool valid = depths[i] < 1.0f && std::abs(clip.w) > std::numeric_limits<float>::min();
+     x[i] = valid ? clip.x / clip.w : 0.0f;
+     y[i] = valid ? clip.y / clip.w : 0.0f;
+     z[i] = valid ? clip.z / clip.w : 0.0f;
+     w[i] = valid ? 1.0f : 0.0f;
+   }
+ }
+
  /// @brief Get the pixel at the specified mouse coordinates
  uint32_t framebuffer::pixel_at(const float current_mouse_x, const float current_mouse_y)
  {
-    // Calculate the pixel coordinates in the framebuffer
-   int pixelX = static_cast<int>(current_mouse_x);
-   int pixelY = framebufferHeight - static_cast<int>(current_mouse_y) - 1;
-   if (pixelX >= 0 && pixelX < framebufferWidth && pixelY >= 0 && pixelY < framebufferHeight) {
-            // Calculate the index in the framebuffer data array
-            int index = (pixelY * framebufferWidth + pixelX) * 4; // Assuming RGBA format
+    // Calculate the index in the framebuffer data array (the image may only cover the region of interest)
+   const int64_t pixel_index = image_index(current_mouse_x, current_mouse_y);
+   if (pixel_index >= 0) {
+            const int64_t index = pixel_index * 4; // Assuming RGBA format (or one 32 bit id)
+
+            /// Raw id from the R32UI pick framebuffer
+            if (image_integer_ids) {
+              uint32_t Selected_ID = 0;
+              std::memcpy(&Selected_ID, &framebufferData[index], sizeof(uint32_t));
+              color_id = Selected_ID;
+              return Selected_ID;
+            }
 
             // Get the pixel values at the specified coordinates
             GLubyte r = framebufferData[index];
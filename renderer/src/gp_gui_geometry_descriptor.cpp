@@ -62,6 +62,39 @@ namespace gridpro_gui {
         currentPrimitiveSet = primitives[name];    
     }
 
+  /// @brief Create an instanced primitive set over the geometry of an existing one
+  /// @param name
+  /// @param source_name
+  /// @details The new set shares the attribute arrays of the source (one copy of the geometry for all the instances)
+  /// @details and starts with its primitive type, color, pick, shading and buffer settings
+    __INLINE__ void GeometryDescriptor::set_new_instanced_primitive_set(const std::string& name, const std::string& source_name) {
+        if(name == source_name) throw std::runtime_error(std::string("Instanced Primitive set needs a name of its own : ") + name);
+
+        auto it = primitives.find(source_name);
+        if(it == primitives.end() || it->second == nullptr) throw std::runtime_error(std::string("Primitive set not found : ") + source_name);
+        const std::shared_ptr<PrimitiveSetInstance> source = it->second;
+
+        set_new_primitive_set(name, source->get_primitive_type_enum());
+        PrimitiveSetInstance& instanced = *currentPrimitiveSet;
+        instanced.positions         = source->positions;
+        instanced.normals           = source->normals;
+        instanced.colors            = source->colors;
+        instanced.indices           = source->indices;
+        instanced.colorFormat       = source->colorFormat;
+        instanced.colorScheme       = source->colorScheme;
+        instanced.shadingModel      = source->shadingModel;
+        instanced.wireframeMode     = source->wireframeMode;
+        instanced.materialProperty  = source->materialProperty;
+        instanced.pickScheme        = source->pickScheme;
+        instanced.vertexLayout      = source->vertexLayout;
+        instanced.vertexCompression = source->vertexCompression;
+        instanced.bufferUsage       = source->bufferUsage;
+        instanced.color             = source->color;
+        instanced.wireframecolor    = source->wireframecolor;
+        instanced.setDirty(PrimitiveSetInstance::DIRTY_ALL);
+        source->instancedSets.push_back(currentPrimitiveSet);
+    }
+
     /// @brief Push a position vector (x, y, z) to the current primitive set
     __INLINE__ void GeometryDescriptor::push_pos3f(const float& x, const float& y, const float& z) {
         
@@ -75,6 +108,7 @@ namespace gridpro_gui {
         /// @warning You can remove this line for performance reasons only if you are sure that you manually set the dirty flag
         #ifdef _ENABLE_AUTOMATIC_DIRTY_FLAG_MANAGEMENT_
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::POSITION_ARRAY, (primitiveSet->positions->size() - 3) * sizeof(float), primitiveSet->positions->size() * sizeof(float));
         #endif
     }
 
@@ -90,6 +124,7 @@ namespace gridpro_gui {
         /// @warning You can remove this line for performance reasons only if you are sure that you manually set the dirty flag
         #ifdef _ENABLE_AUTOMATIC_DIRTY_FLAG_MANAGEMENT_
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_NORMALS);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::NORMAL_ARRAY, (primitiveSet->normals->size() - 3) * sizeof(float), primitiveSet->normals->size() * sizeof(float));
         #endif
     }
 
@@ -114,6 +149,7 @@ namespace gridpro_gui {
         /// @warning You can remove this line for performance reasons only if you are sure that you manually set the dirty flag
         #ifdef _ENABLE_AUTOMATIC_DIRTY_FLAG_MANAGEMENT_
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_COLORS);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::COLOR_ARRAY, primitiveSet->colors->size() - 3, primitiveSet->colors->size());
         #endif
     }
 
@@ -139,6 +175,7 @@ namespace gridpro_gui {
         /// @warning You can remove this line for performance reasons only if you are sure that you manually set the dirty flag
         #ifdef _ENABLE_AUTOMATIC_DIRTY_FLAG_MANAGEMENT_
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_COLORS);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::COLOR_ARRAY, primitiveSet->colors->size() - 4, primitiveSet->colors->size());
         #endif
     }
 
@@ -152,6 +189,7 @@ namespace gridpro_gui {
         /// @warning You can remove this line for performance reasons only if you are sure that you manually set the dirty flag
         #ifdef _ENABLE_AUTOMATIC_DIRTY_FLAG_MANAGEMENT_
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_INDICES);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::INDEX_ARRAY, (primitiveSet->indices->size() - 1) * sizeof(uint32_t), primitiveSet->indices->size() * sizeof(uint32_t));
         #endif
     }
 
@@ -159,24 +197,30 @@ namespace gridpro_gui {
     __INLINE__ void GeometryDescriptor::push_pos_array(const std::vector<float>& position_array) {
 
         auto& primitiveSet = currentPrimitiveSet;
+        const size_t old_size = primitiveSet->positions->size();
         primitiveSet->positions->insert(primitiveSet->positions->end(), position_array.begin(), position_array.end());
-        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS);     
+        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::POSITION_ARRAY, old_size * sizeof(float), primitiveSet->positions->size() * sizeof(float));     
     }
 
     /// @brief Push a normal array to the current primitive set
     __INLINE__ void GeometryDescriptor::push_normal_array(const std::vector<float>& normal_array) {
 
         auto& primitiveSet = currentPrimitiveSet;
+        const size_t old_size = primitiveSet->normals->size();
         primitiveSet->normals->insert(primitiveSet->normals->end(), normal_array.begin(), normal_array.end());
-        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_NORMALS);    
+        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_NORMALS);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::NORMAL_ARRAY, old_size * sizeof(float), primitiveSet->normals->size() * sizeof(float));    
     }
 
     /// @brief Push a color array to the current primitive set
     __INLINE__ void GeometryDescriptor::push_color_array(const std::vector<uint8_t>& color_array) {
 
         auto& primitiveSet = currentPrimitiveSet;
+        const size_t old_size = primitiveSet->colors->size();
         primitiveSet->colors->insert(primitiveSet->colors->end(), color_array.begin(), color_array.end());
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_COLORS);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::COLOR_ARRAY, old_size * sizeof(uint8_t), primitiveSet->colors->size() * sizeof(uint8_t));
 
     }
 
@@ -184,8 +228,10 @@ namespace gridpro_gui {
     __INLINE__ void GeometryDescriptor::push_index_array(const std::vector<uint32_t>& index_array) {
 
         auto& primitiveSet = currentPrimitiveSet;
+        const size_t old_size = primitiveSet->indices->size();
         primitiveSet->indices->insert(primitiveSet->indices->end(), index_array.begin(), index_array.end());
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_INDICES);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::INDEX_ARRAY, old_size * sizeof(uint32_t), primitiveSet->indices->size() * sizeof(uint32_t));
     }
 
     /// @brief Copy a position array to the current primitive set
@@ -194,7 +240,7 @@ namespace gridpro_gui {
         auto& primitiveSet = currentPrimitiveSet;
         //primitiveSet->positions.reset();
         primitiveSet->positions = std::make_shared<std::vector<float>>(position_array);
-        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS);
+        primitiveSet->mark_array_dirty(PrimitiveSetInstance::POSITION_ARRAY);
     }
 
     /// @brief Copy a normal array to the current primitive set
@@ -203,7 +249,7 @@ namespace gridpro_gui {
         auto& primitiveSet = currentPrimitiveSet;
         //primitiveSet->normals.reset();
         primitiveSet->normals = std::make_shared<std::vector<float>>(normal_array);
-        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_NORMALS);
+        primitiveSet->mark_array_dirty(PrimitiveSetInstance::NORMAL_ARRAY);
     }
 
     /// @brief Copy a color array to the current primitive set
@@ -212,7 +258,7 @@ namespace gridpro_gui {
         auto& primitiveSet = currentPrimitiveSet;
         //primitiveSet->colors.reset();
         primitiveSet->colors = std::make_shared<std::vector<uint8_t>>(color_array);
-        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_COLORS);
+        primitiveSet->mark_array_dirty(PrimitiveSetInstance::COLOR_ARRAY);
     }
 
     /// @brief Copy a Index array to the current primitive set
@@ -221,7 +267,7 @@ namespace gridpro_gui {
         auto& primitiveSet = currentPrimitiveSet;
         //primitiveSet->indices.reset();
         primitiveSet->indices = std::make_shared<std::vector<uint32_t>>(index_array);
-        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_INDICES);
+        primitiveSet->mark_array_dirty(PrimitiveSetInstance::INDEX_ARRAY);
     }
 
     /// @brief Move a position array to the current primitive set
@@ -230,7 +276,7 @@ namespace gridpro_gui {
         auto& primitiveSet = currentPrimitiveSet;
         //primitiveSet->positions.reset();
         primitiveSet->positions = std::make_shared<std::vector<float>>(std::move(position_array));
-        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS);
+        primitiveSet->mark_array_dirty(PrimitiveSetInstance::POSITION_ARRAY);
     }
 
     /// @brief Move a normal array to the current primitive set
@@ -239,7 +285,7 @@ namespace gridpro_gui {
         auto& primitiveSet = currentPrimitiveSet;
         //primitiveSet->normals.reset();
         primitiveSet->normals = std::make_shared<std::vector<float>>(std::move(normal_array));
-        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_NORMALS);
+        primitiveSet->mark_array_dirty(PrimitiveSetInstance::NORMAL_ARRAY);
     }
 
     /// @brief Move a color array to the current primitive set
@@ -248,7 +294,7 @@ namespace gridpro_gui {
         auto& primitiveSet = currentPrimitiveSet;
         //primitiveSet->colors.reset();
         primitiveSet->colors = std::make_shared<std::vector<uint8_t>>(std::move(color_array));
-        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_COLORS);
+        primitiveSet->mark_array_dirty(PrimitiveSetInstance::COLOR_ARRAY);
     }
 
     /// @brief Move a Index array to the current primitive set
@@ -257,7 +303,57 @@ namespace gridpro_gui {
         auto& primitiveSet = currentPrimitiveSet;
         //primitiveSet->indices.reset();
         primitiveSet->indices = std::make_shared<std::vector<uint32_t>>(std::move(index_array));
+        primitiveSet->mark_array_dirty(PrimitiveSetInstance::INDEX_ARRAY);
+    }
+
+
+    /// @brief Overwrite positions in place starting at float element offset
+    /// @details Only the overwritten interval is re-uploaded to the GPU
+    __INLINE__ void GeometryDescriptor::update_positions(const size_t& offset, const std::vector<float>& span) {
+
+        auto& primitiveSet = currentPrimitiveSet;
+        #ifdef _ENABLE_RUNTIME_SAFETY_CHECKS_
+        if(offset + span.size() > primitiveSet->positions->size()) { throw std::runtime_error("update_positions() : range exceeds the position array"); }
+        #endif
+        std::copy(span.begin(), span.end(), primitiveSet->positions->begin() + offset);
+        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::POSITION_ARRAY, offset * sizeof(float), (offset + span.size()) * sizeof(float));
+    }
+
+    /// @brief Overwrite normals in place starting at float element offset
+    __INLINE__ void GeometryDescriptor::update_normals(const size_t& offset, const std::vector<float>& span) {
+
+        auto& primitiveSet = currentPrimitiveSet;
+        #ifdef _ENABLE_RUNTIME_SAFETY_CHECKS_
+        if(offset + span.size() > primitiveSet->normals->size()) { throw std::runtime_error("update_normals() : range exceeds the normal array"); }
+        #endif
+        std::copy(span.begin(), span.end(), primitiveSet->normals->begin() + offset);
+        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_NORMALS);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::NORMAL_ARRAY, offset * sizeof(float), (offset + span.size()) * sizeof(float));
+    }
+
+    /// @brief Overwrite colors in place starting at byte element offset
+    __INLINE__ void GeometryDescriptor::update_colors(const size_t& offset, const std::vector<uint8_t>& span) {
+
+        auto& primitiveSet = currentPrimitiveSet;
+        #ifdef _ENABLE_RUNTIME_SAFETY_CHECKS_
+        if(offset + span.size() > primitiveSet->colors->size()) { throw std::runtime_error("update_colors() : range exceeds the color array"); }
+        #endif
+        std::copy(span.begin(), span.end(), primitiveSet->colors->begin() + offset);
+        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_COLORS);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::COLOR_ARRAY, offset, offset + span.size());
+    }
+
+    /// @brief Overwrite indices in place starting at index element offset
+    __INLINE__ void GeometryDescriptor::update_indices(const size_t& offset, const std::vector<uint32_t>& span) {
+
+        auto& primitiveSet = currentPrimitiveSet;
+        #ifdef _ENABLE_RUNTIME_SAFETY_CHECKS_
+        if(offset + span.size() > primitiveSet->indices->size()) { throw std::runtime_error("update_indices() : range exceeds the index array"); }
+        #endif
+        std::copy(span.begin(), span.end(), primitiveSet->indices->begin() + offset);
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_INDICES);
+        primitiveSet->add_dirty_range(PrimitiveSetInstance::INDEX_ARRAY, offset * sizeof(uint32_t), (offset + span.size()) * sizeof(uint32_t));
     }
 
 
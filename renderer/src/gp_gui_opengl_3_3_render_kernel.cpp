@@ -8,7 +8,12 @@
 #include "gp_gui_texture.h"
 #include "gp_gui_instrumentation.h"
 #include "gp_gui_pixel_utils.h"
+#include "gp_gui_batched_render_path.h"
+#include "gp_gui_gl_state_cache.h"
+#include "gp_gui_scene.h"
+#include "gp_gui_scene_uniform_buffer.h"
 #include <exception>
+#include <cstring>
 //#include <glm/gtx/string_cast.hpp>
 // Define a macro for OpenMP pragmas
 
@@ -28,13 +33,29 @@ namespace gridpro_gpu_metrics
 
 namespace gridpro_gui
 {
+    namespace
+    {
+        /// Uniform names hashed at compile time (shared by the Basic / Select shaders)
+        constexpr UniformName OBJECT_COLOR("object_color");
+        constexpr UniformName SELECTION_INIT_ID("selection_init_id");
+        constexpr UniformName POSITION_OFFSET("position_offset");
+        constexpr UniformName POSITION_SCALE("position_scale");
+        constexpr UniformName PEEL_PREVIOUS_LAYER("peel_previous_layer");
+        constexpr UniformName ENTITY_WORLD("entity_world");
+        /// Instanced shaders
+        constexpr UniformName FALLBACK_COLOR("fallback_color");
+        constexpr UniformName USE_INSTANCE_COLOR("use_instance_color");
+        constexpr UniformName INSTANCE_PICK_STRIDE("instance_pick_stride");
+        constexpr UniformName PICK_PRIMITIVES("pick_primitives");
+    }
+
     OpenGL_3_3_RenderKernel::OpenGL_3_3_RenderKernel(std::shared_ptr<GeometryDescriptor>& geometry_descriptor)
-    : m_geometry_descriptor(geometry_descriptor) , init_flag(false)
+    : m_geometry_descriptor(geometry_descriptor) , init_flag(false), m_kernel_id(0), m_reserved_color_start(0), m_reserved_color_count(0)
     {
        init();
     }
 
-    OpenGL_3_3_RenderKernel::OpenGL_3_3_RenderKernel()  : init_flag(false)
+    OpenGL_3_3_RenderKernel::OpenGL_3_3_RenderKernel()  : init_flag(false), m_kernel_id(0), m_reserved_color_start(0), m_reserved_color_count(0)
     {
 
     }
@@ -43,7 +64,13 @@ namespace gridpro_gui
     {   
         if(init_flag) return;
         if(m_geometry_descriptor == nullptr) throw std::runtime_error("Geometry Descriptor is not set");
-        m_vao = std::make_shared<VertexArrayObject>(m_geometry_descriptor.get());
+        /// A VAO handed over by set_geometry_descriptor is either staged or already uploaded (batch commits)
+        if(m_vao != nullptr && m_vao->is_staged())
+            m_vao->upload_staged();
+        else if(m_vao == nullptr)
+            m_vao = std::make_shared<VertexArrayObject>(m_geometry_descriptor.get());
+        if(is_instanced())
+            m_vao->set_instance_attributes((*m_geometry_descriptor)->get_instance_transforms(), (*m_geometry_descriptor)->get_instance_colors());
         gridpro_gpu_metrics::gpu_current_vertex_array_size +=  m_vao->get_vbo_size();
         std::cout << "Current Vertex Array Size = " << gridpro_gpu_metrics::gpu_current_vertex_array_size << std::endl;
         m_geometry_descriptor->clearDirtyFlags();
@@ -63,6 +90,15 @@ namespace gridpro_gui
        m_geometry_descriptor = geometry_descriptor;
        init();
     }
+
+    /// @brief Set the geometry descriptor with a pre-packed VAO (For commits prepared on the worker pool or uploaded in a batch)
+    void OpenGL_3_3_RenderKernel::set_geometry_descriptor(const std::shared_ptr<GeometryDescriptor>& geometry_descriptor, const std::shared_ptr<VertexArrayObject>& staged_vao)
+    {
+       reset();
+       m_geometry_descriptor = geometry_descriptor;
+       m_vao = staged_vao;
+       init();
+    }
     
     /// @brief Render the geometry in display mode (For rendering the geometry)
     bool OpenGL_3_3_RenderKernel::render_display_mode()
@@ -71,17 +107,18 @@ namespace gridpro_gui
         try 
         { 
           if((*m_geometry_descriptor)->positions_vector().size() == 0) return false;
+          /// Display draws may run outside scene.update() (or with the render systems disabled), so the SceneBlock is refreshed
+          /// here as well (a memcmp when the matrices did not change, the bind is skipped by the GLStateCache)
+          SceneUniformBuffer::GetInstance().update(Event::Publisher::GetInstance()->get_scene_state());
+          sync_gpu_buffers();
           
             // Bind the texture
             // m_texture->bind(0);
-            m_shader = ShaderLibrary::GetShader("BasicShader");
+            m_shader = ShaderLibrary::GetShader(is_instanced() ? "InstancedBasicShader" : "BasicShader");
             m_shader->bind();
-            SceneState& scene_state = Event::Publisher::GetInstance()->get_scene_state();
           
             /// Set the shader uniforms
-            m_shader->SetMat4fv("projection", scene_state.m_projection);
-            m_shader->SetMat4fv("model", scene_state.m_model);
-            m_shader->SetMat4fv("view", scene_state.m_view);        
+            set_dequantization_uniforms();
                  
             // Enable if you want to use the texture  
             // m_shader->Set1i("textureSampler", *m_texture);
@@ -91,12 +128,12 @@ namespace gridpro_gui
             if((*m_geometry_descriptor)->get_wireframe_mode_enum() == GL_WIREFRAME_OVERLAY)
             {
               glm::vec4 object_color = glm::make_vec4((*m_geometry_descriptor)->color.get_color().data());
-              m_shader->SetVec4fv("object_color", object_color);   
+              set_display_color(object_color, false);   
               // Draw Call
               execute_draw_command();
               //// Draw the in wireframe only or fill mode only based on the rasteriser state
               glm::vec4 wireframe_color = glm::make_vec4((*m_geometry_descriptor)->wireframecolor.get_color().data());
-              m_shader->SetVec4fv("object_color", wireframe_color);          
+              set_display_color(wireframe_color, true);          
             
               set_rasteriser_state();
             
@@ -108,7 +145,7 @@ namespace gridpro_gui
             else if((*m_geometry_descriptor)->get_wireframe_mode_enum() == GL_WIREFRAME_ONLY)
             {
               glm::vec4 wireframe_color = glm::make_vec4((*m_geometry_descriptor)->wireframecolor.get_color().data());
-              m_shader->SetVec4fv("object_color", wireframe_color);          
+              set_display_color(wireframe_color, true);          
             
               set_rasteriser_state();
             
@@ -121,7 +158,7 @@ namespace gridpro_gui
             {
               //// Draw the in wireframe only or fill mode only based on the rasteriser state
               glm::vec4 wireframe_color = glm::make_vec4((*m_geometry_descriptor)->wireframecolor.get_color().data());
-              m_shader->SetVec4fv("object_color", wireframe_color);          
+              set_display_color(wireframe_color, false);          
             
               set_rasteriser_state();
             
@@ -154,38 +191,59 @@ namespace gridpro_gui
         try 
         {
             if((*m_geometry_descriptor)->positions_vector().size() == 0) return false;
+            sync_gpu_buffers();
             
             /// Get the pick information
             GLenum pick_scheme = (*m_geometry_descriptor)->get_pick_scheme_enum();
             if(pick_scheme == GL_PICK_NONE) return false;
+            ensure_color_reservation();
 
             GLenum primitive_type = (*m_geometry_descriptor)->get_primitive_type_enum();
 
             if(pick_scheme == GL_PICK_BY_VERTEX) primitive_type = GL_POINTS;
 
-            if(pick_scheme == GL_PICK_BY_PRIMITIVE || pick_scheme == GL_PICK_BY_VERTEX)
-               m_shader = ShaderLibrary::GetShader("SelectPrimitiveShader");
+            /// The offscreen R32UI pick target takes the raw 32 bit id, the back buffer the RGB encoded one
+            const framebuffer* frame_buffer = Event::Publisher::GetInstance()->frame_buffer();
+            const bool integer_ids = frame_buffer->uses_integer_ids();
+
+            if(is_instanced())
+               m_shader = ShaderLibrary::GetShader(integer_ids ? "InstancedIdSelectShader" : "InstancedSelectShader");
+
+            else if(pick_scheme == GL_PICK_BY_PRIMITIVE || pick_scheme == GL_PICK_BY_VERTEX)
+               m_shader = ShaderLibrary::GetShader(integer_ids ? "IdSelectPrimitiveShader" : "SelectPrimitiveShader");
 
             else if(pick_scheme == GL_PICK_GEOMETRY)
-               m_shader = ShaderLibrary::GetShader("SelectGeometryShader");
+               m_shader = ShaderLibrary::GetShader(integer_ids ? "IdSelectGeometryShader" : "SelectGeometryShader");
             
             m_shader->bind();
-            SceneState& scene_state = Event::Publisher::GetInstance()->get_scene_state();
           
             /// Set the shader uniforms
-            m_shader->SetMat4fv("projection", scene_state.m_projection);
-            m_shader->SetMat4fv("model", scene_state.m_model);
-            m_shader->SetMat4fv("view", scene_state.m_view);
+            set_dequantization_uniforms();
 
-            if(pick_scheme == GL_PICK_BY_PRIMITIVE || pick_scheme == GL_PICK_BY_VERTEX)
-                m_shader->Set1i("selection_init_id", m_geometry_descriptor->get_color_id_reserve_start());  
+            if(is_instanced())
+            {
+                /// Every instance has its own block of ids : start + instance * stride + vertex / primitive id
+                m_shader->Set1ui(SELECTION_INIT_ID, m_geometry_descriptor->get_color_id_reserve_start());
+                m_shader->Set1ui(INSTANCE_PICK_STRIDE, static_cast<uint32_t>((*m_geometry_descriptor)->get_pickable_entities_per_instance()));
+                m_shader->Set1i(PICK_PRIMITIVES, pick_scheme != GL_PICK_GEOMETRY ? 1 : 0);
+                if(integer_ids) m_shader->Set1i(PEEL_PREVIOUS_LAYER, frame_buffer->current_peel_layer() > 0 ? 1 : 0);
+            }
+
+            else if(integer_ids)
+            {
+                m_shader->Set1ui(SELECTION_INIT_ID, m_geometry_descriptor->get_color_id_reserve_start());
+                m_shader->Set1i(PEEL_PREVIOUS_LAYER, frame_buffer->current_peel_layer() > 0 ? 1 : 0);
+            }
+
+            else if(pick_scheme == GL_PICK_BY_PRIMITIVE || pick_scheme == GL_PICK_BY_VERTEX)
+                m_shader->Set1i(SELECTION_INIT_ID, m_geometry_descriptor->get_color_id_reserve_start());  
 
             else if(pick_scheme == GL_PICK_GEOMETRY)
             {
                 uint32_t unique_color = m_geometry_descriptor->get_color_id_reserve_start();
                 PixelData color = PixelData(unique_color);
                 glm::vec3 unique_color_vec = glm::vec3(color.r_float(), color.g_float(), color.b_float());
-                m_shader->SetVec3fv("selection_init_id", unique_color_vec);  
+                m_shader->SetVec3fv(SELECTION_INIT_ID, unique_color_vec);  
             }
             //// Draw the geometry   
             m_vao->bind();
@@ -194,11 +252,7 @@ namespace gridpro_gui
 
             execute_draw_command(primitive_type);
             
-            reset_rasteriser_state();
-
-            // Unbind the all the objects
-            m_vao->unbind();
-            m_shader->unbind();
+            /// Program, VAO and rasteriser state stay bound for the next (sorted) draw, the render system restores the defaults at the end of the pass
             DEBUG_PRINT("Rendered in Select Mode Sucessfully");
         }
 
@@ -211,6 +265,103 @@ namespace gridpro_gui
         return true;
     }
 
+    /// @brief Sort key grouping draws by program (instanced programs last), then rasteriser state, then primitive type (draw in ascending order to minimise state changes)
+    const uint64_t OpenGL_3_3_RenderKernel::get_draw_sort_key(const bool selection_mode) const
+    {
+        if(m_geometry_descriptor == nullptr) return 0;
+
+        uint64_t program_index = 0;
+        GLenum   primitive_type = (*m_geometry_descriptor)->get_primitive_type_enum();
+        if(selection_mode)
+        {
+            GLenum pick_scheme = (*m_geometry_descriptor)->get_pick_scheme_enum();
+            if(pick_scheme == GL_PICK_BY_PRIMITIVE || pick_scheme == GL_PICK_BY_VERTEX) program_index = 1;
+            else if(pick_scheme == GL_PICK_GEOMETRY)                                    program_index = 2;
+            if(pick_scheme == GL_PICK_BY_VERTEX) primitive_type = GL_POINTS;
+        }
+
+        const uint64_t wireframe = ((*m_geometry_descriptor)->get_wireframe_mode_enum() != GL_WIREFRAME_NONE) ? 1 : 0;
+        const uint64_t instanced = is_instanced() ? 1 : 0;
+        return (instanced << 32) | (program_index << 24) | (wireframe << 16) | (static_cast<uint64_t>(primitive_type) & 0xFFFF);
+    }
+
+    /// @brief Pick scheme, primitive type, wireframe mode, id range, draw range, instance count and world matrix of this kernel, plus the
+    /// geometry version of its primitive set (a counter, so edits are seen whether or not a draw has already uploaded them)
+    const uint64_t OpenGL_3_3_RenderKernel::get_pick_signature() const
+    {
+        if(m_geometry_descriptor == nullptr || m_vao == nullptr) return 0;
+
+        typedef GeometryDescriptor::PrimitiveSetInstance PrimitiveSet;
+        const PrimitiveSet& primitive_set = *(m_geometry_descriptor->currentPrimitiveSet);
+
+        const uint64_t fields[] = { m_kernel_id, primitive_set.get_pick_scheme_enum(), primitive_set.get_primitive_type_enum(),
+                                    primitive_set.get_wireframe_mode_enum(), m_geometry_descriptor->get_color_id_reserve_start(),
+                                    primitive_set.get_geometry_version(), primitive_set.get_num_vertices(),
+                                    static_cast<uint64_t>(m_vao->get_base_vertex()), m_vao->get_index_offset(), get_world_version(),
+                                    primitive_set.get_num_instances() };
+        uint64_t signature = 14695981039346656037ull;
+        for(const uint64_t field : fields)
+            signature = (signature ^ field) * 1099511628211ull;
+        return signature;
+    }
+
+    /// @brief Describe this kernel's draw for the batched render path (For multi draw indirect submission)
+    bool OpenGL_3_3_RenderKernel::prepare_batched_draw(const bool selection_mode, BatchedDrawRecord& draw)
+    {
+        if(m_geometry_descriptor == nullptr || m_vao == nullptr) return false;
+        if((*m_geometry_descriptor)->positions_vector().size() == 0) return false;
+
+        sync_gpu_buffers();
+        /// Instanced sets keep their own glDrawElementsInstanced call (the per draw data has no room for instance arrays)
+        if(!m_vao->is_batchable() || is_instanced()) return false;
+
+        GLenum primitive_type = (*m_geometry_descriptor)->get_primitive_type_enum();
+        if(primitive_type == GL_NONE_NULL) return false;
+
+        draw.key.shader_name = "BatchedBasicShader";
+        if(selection_mode)
+        {
+            GLenum pick_scheme = (*m_geometry_descriptor)->get_pick_scheme_enum();
+            if(pick_scheme == GL_PICK_NONE) return false;
+            if(pick_scheme == GL_PICK_BY_VERTEX) primitive_type = GL_POINTS;
+            ensure_color_reservation();
+
+            if(Event::Publisher::GetInstance()->frame_buffer()->uses_integer_ids())
+                draw.key.shader_name = (pick_scheme == GL_PICK_GEOMETRY) ? "BatchedIdSelectGeometryShader" : "BatchedIdSelectPrimitiveShader";
+            else
+                draw.key.shader_name = (pick_scheme == GL_PICK_GEOMETRY) ? "BatchedSelectGeometryShader" : "BatchedSelectPrimitiveShader";
+        }
+
+        draw.key.primitive_type = primitive_type;
+        draw.key.wireframe_mode = (*m_geometry_descriptor)->get_wireframe_mode_enum();
+        draw.key.vertex_buffer  = m_vao->get_vbo();
+        draw.key.index_buffer   = m_vao->get_ibo();
+        draw.key.index_type     = m_vao->get_index_type();
+        draw.key.vertex_format  = m_vao->get_vertex_format();
+
+        draw.command.count         = static_cast<GLuint>((*m_geometry_descriptor)->get_num_vertices());
+        draw.command.instanceCount = 1;
+        draw.command.firstIndex    = m_vao->get_first_index();
+        draw.command.baseVertex    = m_vao->get_base_vertex();
+        draw.command.baseInstance  = 0;
+
+        const std::array<float, 4> color           = (*m_geometry_descriptor)->color.get_color();
+        const std::array<float, 4> wireframe_color = (*m_geometry_descriptor)->wireframecolor.get_color();
+        for(size_t i = 0; i < 4; ++i)
+        {
+            draw.data.color[i]           = color[i];
+            draw.data.wireframe_color[i] = wireframe_color[i];
+            draw.data.position_offset[i] = i < 3 ? m_vao->get_position_offset()[i] : 0.0f;
+            draw.data.position_scale[i]  = i < 3 ? m_vao->get_position_scale()[i]  : 0.0f;
+        }
+        draw.data.pick_id_base = m_geometry_descriptor->get_color_id_reserve_start();
+        draw.data.padding[0] = draw.data.padding[1] = draw.data.padding[2] = 0;
+        std::memcpy(draw.data.world, &get_world_matrix()[0][0], sizeof(draw.data.world));
+
+        draw.vao = m_vao.get();
+        return true;
+    }
+
     /// @brief Reset the render kernel (For reinitialization of the kernel with new geometry descriptor)
     void OpenGL_3_3_RenderKernel::reset()
     {
@@ -221,14 +372,91 @@ namespace gridpro_gui
         init_flag = false;
     } 
 
+    /// @brief Push the dirty parts of the current primitive set to the GPU buffers before drawing
+    void OpenGL_3_3_RenderKernel::sync_gpu_buffers()
+    {
+        typedef GeometryDescriptor::PrimitiveSetInstance PrimitiveSet;
+        PrimitiveSet& primitive_set = *(m_geometry_descriptor->currentPrimitiveSet);
+
+        const uint32_t vertex_flags = PrimitiveSet::DIRTY_POSITIONS | PrimitiveSet::DIRTY_NORMALS | PrimitiveSet::DIRTY_COLORS | PrimitiveSet::DIRTY_VERTEX_LAYOUT;
+        const uint32_t index_flags  = PrimitiveSet::DIRTY_INDICES | PrimitiveSet::DIRTY_VERTEX_LAYOUT;
+        const uint32_t instance_flags = PrimitiveSet::DIRTY_INSTANCES;
+        if(!primitive_set.isDirty(vertex_flags | index_flags | instance_flags)) return;
+
+        if(primitive_set.isDirty(vertex_flags)) m_vao->update_vbo();
+        if(primitive_set.isDirty(index_flags))  m_vao->update_ibo();
+        /// Cleared instances release the instance buffer
+        if(primitive_set.isDirty(instance_flags)) m_vao->set_instance_attributes(primitive_set.get_instance_transforms(), primitive_set.get_instance_colors());
+
+        primitive_set.clearDirty(vertex_flags | index_flags | instance_flags);
+    }
+
+    /// @brief Ask the scene for a new pick id range if the pick scheme / primitive count changed since the last reservation
+    /// (two compares per draw for unchanged entities, the scene only works on the changed ones)
+    void OpenGL_3_3_RenderKernel::ensure_color_reservation()
+    {
+        const uint32_t required = m_geometry_descriptor->get_color_id_reserve_count();
+        if(m_reserved_color_count == required && m_reserved_color_start == m_geometry_descriptor->get_color_id_reserve_start()) return;
+
+        Gp_gui_scene* scene = Event::Publisher::GetInstance()->get_scene_ptr();
+        if(scene == nullptr) return;
+
+        scene->reserve_color_ids(m_kernel_id, *m_geometry_descriptor);
+        m_reserved_color_start = m_geometry_descriptor->get_color_id_reserve_start();
+        m_reserved_color_count = required;
+    }
+
+    /// @brief Set the position dequantization uniforms of the bound shader (identity for float positions)
+    void OpenGL_3_3_RenderKernel::set_dequantization_uniforms()
+    {
+        m_shader->SetVec3fv(POSITION_OFFSET, glm::make_vec3(m_vao->get_position_offset().data()));
+        m_shader->SetVec3fv(POSITION_SCALE,  glm::make_vec3(m_vao->get_position_scale().data()));
+        m_shader->SetMat4fv(ENTITY_WORLD, get_world_matrix());
+    }
+
+    /// @brief Scene graph world matrix of this kernel's entity (resolved lazily by the scene, identity without a transform)
+    const uint32_t OpenGL_3_3_RenderKernel::get_world_version() const
+    {
+        Gp_gui_scene* scene = Event::Publisher::GetInstance()->get_scene_ptr();
+        return scene != nullptr ? scene->Transforms.get_world_version(m_kernel_id) : 0;
+    }
+
+    const glm::mat4& OpenGL_3_3_RenderKernel::get_world_matrix() const
+    {
+        static const glm::mat4 identity(1.0f);
+        Gp_gui_scene* scene = Event::Publisher::GetInstance()->get_scene_ptr();
+        return scene != nullptr ? scene->Transforms.get_world_matrix(m_kernel_id) : identity;
+    }
+
+    const bool OpenGL_3_3_RenderKernel::is_instanced() const
+    {
+        return m_geometry_descriptor != nullptr && (*m_geometry_descriptor)->is_instanced();
+    }
+
+    void OpenGL_3_3_RenderKernel::set_display_color(const glm::vec4& color, const bool wireframe_pass)
+    {
+        if(!is_instanced())
+        {
+            m_shader->SetVec4fv(OBJECT_COLOR, color);
+            return;
+        }
+        m_shader->SetVec4fv(FALLBACK_COLOR, color);
+        m_shader->Set1i(USE_INSTANCE_COLOR, (!wireframe_pass && m_vao->has_instance_colors()) ? 1 : 0);
+    }
+
     void OpenGL_3_3_RenderKernel::set_rasteriser_state()
     {
         if((*m_geometry_descriptor)->get_wireframe_mode_enum() != GL_WIREFRAME_NONE)
         { 
-         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-         glEnable(GL_POLYGON_OFFSET_FILL);
-         glPolygonOffset(1.0, 1.0);
-         glLineWidth(4.0f);
+         GLStateCache::GetInstance().polygon_mode(GL_LINE);
+         GLStateCache::GetInstance().polygon_offset_fill(true);
+         GLStateCache::GetInstance().polygon_offset(1.0f, 1.0f);
+         GLStateCache::GetInstance().line_width(4.0f);
+        }
+        else
+        {
+         GLStateCache::GetInstance().polygon_offset_fill(false);
+         GLStateCache::GetInstance().polygon_mode(GL_FILL);
         }
     }
 
@@ -236,9 +464,9 @@ namespace gridpro_gui
     {
         if((*m_geometry_descriptor)->get_wireframe_mode_enum() != GL_WIREFRAME_NONE)
         {         
-         glDisable(GL_POLYGON_OFFSET_FILL);
-         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-         glLineWidth(4.0f);
+         GLStateCache::GetInstance().polygon_offset_fill(false);
+         GLStateCache::GetInstance().polygon_mode(GL_FILL);
+         GLStateCache::GetInstance().line_width(4.0f);
         }
     }
     
@@ -252,14 +480,28 @@ namespace gridpro_gui
 
       if(my_primitive_type == GL_NONE_NULL) throw std::runtime_error("Primitive type is not set");
       
+      /// Instanced sets draw the shared geometry once per instance of the instance buffer
+      const GLsizei instances = is_instanced() ? m_vao->get_num_instances() : 0;
+
       if((*m_geometry_descriptor)->indices_vector().size() != 0)
       {
-        Renderer::GL_API()->glDrawElements(my_primitive_type, (*m_geometry_descriptor)->get_num_vertices(), GL_UNSIGNED_INT, nullptr);
+        /// Base vertex and index offset locate this entity inside the shared arena pages (0 for private buffers)
+        if(instances > 0)
+          Renderer::GL_API()->glDrawElementsInstancedBaseVertex(my_primitive_type, (*m_geometry_descriptor)->get_num_vertices(), m_vao->get_index_type(),
+                                                                (void*)(uintptr_t)m_vao->get_index_offset(), instances, m_vao->get_base_vertex());
+        else
+          Renderer::GL_API()->glDrawElementsBaseVertex(my_primitive_type, (*m_geometry_descriptor)->get_num_vertices(), m_vao->get_index_type(),
+                                                       (void*)(uintptr_t)m_vao->get_index_offset(), m_vao->get_base_vertex());
+      }
+
+      else if(instances > 0)
+      {
+        Renderer::GL_API()->glDrawArraysInstanced(my_primitive_type, m_vao->get_base_vertex(), (*m_geometry_descriptor)->get_num_vertices(), instances);
       }
 
       else
       {
-        Renderer::GL_API()->glDrawArrays(my_primitive_type, 0, (*m_geometry_descriptor)->get_num_vertices());  
+        Renderer::GL_API()->glDrawArrays(my_primitive_type, m_vao->get_base_vertex(), (*m_geometry_descriptor)->get_num_vertices());  
       }
     }
 
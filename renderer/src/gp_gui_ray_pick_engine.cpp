@@ -0,0 +1,531 @@
+#include "gp_gui_ray_pick_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace gridpro_gui
+{
+    namespace
+    {
+        /// Elements per leaf of the hierarchies
+        constexpr uint32_t BVH_LEAF_SIZE = 4;
+
+        /// Entry / exit distances of the ray in the box, false if it misses or enters beyond max_distance
+        inline bool intersect_box(const PickRay& ray, const glm::vec3& inverse_direction, const glm::vec3& min, const glm::vec3& max, const float max_distance)
+        {
+            const glm::vec3 t0 = (min - ray.origin) * inverse_direction;
+            const glm::vec3 t1 = (max - ray.origin) * inverse_direction;
+            const glm::vec3 near_t = glm::min(t0, t1);
+            const glm::vec3 far_t  = glm::max(t0, t1);
+            const float enter = std::max(std::max(near_t.x, near_t.y), std::max(near_t.z, 0.0f));
+            const float exit  = std::min(std::min(far_t.x, far_t.y), far_t.z);
+            return enter <= exit && enter <= max_distance;
+        }
+
+        /// False if the box is entirely on the outer side of one plane
+        inline bool overlap_box(const PickFrustum& frustum, const glm::vec3& min, const glm::vec3& max)
+        {
+            for(const glm::vec4& plane : frustum.planes)
+            {
+                const glm::vec3 farthest(plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y, plane.z >= 0.0f ? max.z : min.z);
+                if(glm::dot(glm::vec3(plane), farthest) + plane.w < 0.0f) return false;
+            }
+            return true;
+        }
+
+        inline glm::vec4 matrix_row(const glm::mat4& matrix, const int row)
+        {
+            return glm::vec4(matrix[0][row], matrix[1][row], matrix[2][row], matrix[3][row]);
+        }
+
+        inline glm::vec4 normalise_plane(const glm::vec4& plane)
+        {
+            const float length = glm::length(glm::vec3(plane));
+            return length > 0.0f ? plane / length : plane;
+        }
+
+        /// Cursor position (window coordinates, y down) to normalised device coordinates
+        inline glm::vec2 cursor_to_ndc(const float x, const float y, const glm::vec4& viewport)
+        {
+            return glm::vec2(2.0f * (x - viewport.x) / viewport.z - 1.0f, 1.0f - 2.0f * (y - viewport.y) / viewport.w);
+        }
+    }
+
+    /// @brief Enumerate the elements the GPU would draw for the pick scheme of the primitive set
+    void PrimitiveBVH::build(const GeometryDescriptor::PrimitiveSetInstance& primitive_set, const float line_tolerance, const float point_radius)
+    {
+        typedef GeometryDescriptor::PrimitiveSetInstance PrimitiveSet;
+
+        m_elements.clear();
+        m_nodes.clear();
+        m_bounds_min = m_bounds_max = glm::vec3(0.0f);
+
+        const PrimitiveSet::PickScheme pick_scheme = primitive_set.get_pick_scheme();
+        const std::shared_ptr<std::vector<float>>    position_array = primitive_set.get_position_weak_ptr().lock();
+        const std::shared_ptr<std::vector<uint32_t>> index_array    = primitive_set.get_indices_weak_ptr().lock();
+        if(pick_scheme == PrimitiveSet::PICK_NONE || position_array == nullptr) return;
+
+        const std::vector<float>&    positions = *position_array;
+        const std::vector<uint32_t>* indices   = (index_array != nullptr && !index_array->empty()) ? index_array.get() : nullptr;
+        const size_t stream_size = indices ? indices->size() : positions.size() / 3;
+        const size_t vertex_count = positions.size() / 3;
+
+        /// Position of the n-th vertex of the draw (through the index buffer if there is one)
+        auto vertex = [&](const size_t n) -> glm::vec3
+        {
+            const size_t v = indices ? (*indices)[n] : n;
+            if(v >= vertex_count) throw std::runtime_error("PrimitiveBVH : index " + std::to_string(v) + " is out of range");
+            return glm::vec3(positions[3 * v], positions[3 * v + 1], positions[3 * v + 2]);
+        };
+        /// Sub entity id of a primitive (the whole set is one id in PICK_GEOMETRY)
+        auto primitive_id = [&](const size_t primitive) -> uint32_t
+        {
+            return pick_scheme == PrimitiveSet::PICK_GEOMETRY ? 0 : static_cast<uint32_t>(primitive);
+        };
+
+        /// Vertex picking draws every vertex of the stream as a point, gl_PrimitiveID is then the stream position
+        if(pick_scheme == PrimitiveSet::PICK_BY_VERTEX)
+        {
+            m_elements.reserve(stream_size);
+            for(size_t n = 0; n < stream_size; ++n) add_point(vertex(n), static_cast<uint32_t>(n), point_radius);
+        }
+        else switch(primitive_set.get_primitive_type())
+        {
+            case PrimitiveSet::POINTS:
+                for(size_t n = 0; n < stream_size; ++n) add_point(vertex(n), primitive_id(n), point_radius);
+                break;
+            case PrimitiveSet::LINES:
+                for(size_t n = 0; n + 1 < stream_size; n += 2) add_segment(vertex(n), vertex(n + 1), primitive_id(n / 2), line_tolerance);
+                break;
+            case PrimitiveSet::LINE_STRIP:
+                for(size_t n = 0; n + 1 < stream_size; ++n) add_segment(vertex(n), vertex(n + 1), primitive_id(n), line_tolerance);
+                break;
+            case PrimitiveSet::LINE_LOOP:
+                for(size_t n = 0; n + 1 < stream_size; ++n) add_segment(vertex(n), vertex(n + 1), primitive_id(n), line_tolerance);
+                if(stream_size > 2) add_segment(vertex(stream_size - 1), vertex(0), primitive_id(stream_size - 1), line_tolerance);
+                break;
+            case PrimitiveSet::TRIANGLES:
+                for(size_t n = 0; n + 2 < stream_size; n += 3) add_triangle(vertex(n), vertex(n + 1), vertex(n + 2), primitive_id(n / 3));
+                break;
+            case PrimitiveSet::TRIANGLE_STRIP:
+                for(size_t n = 0; n + 2 < stream_size; ++n) add_triangle(vertex(n), vertex(n + 1), vertex(n + 2), primitive_id(n));
+                break;
+            case PrimitiveSet::TRIANGLE_FAN:
+                for(size_t n = 1; n + 1 < stream_size; ++n) add_triangle(vertex(0), vertex(n), vertex(n + 1), primitive_id(n - 1));
+                break;
+            case PrimitiveSet::POLYGON:
+                for(size_t n = 1; n + 1 < stream_size; ++n) add_triangle(vertex(0), vertex(n), vertex(n + 1), primitive_id(0));
+                break;
+            case PrimitiveSet::QUADS:
+                for(size_t n = 0; n + 3 < stream_size; n += 4)
+                {
+                    add_triangle(vertex(n), vertex(n + 1), vertex(n + 2), primitive_id(n / 4));
+                    add_triangle(vertex(n), vertex(n + 2), vertex(n + 3), primitive_id(n / 4));
+                }
+                break;
+            case PrimitiveSet::QUAD_STRIP:
+                for(size_t n = 0; n + 3 < stream_size; n += 2)
+                {
+                    add_triangle(vertex(n), vertex(n + 1), vertex(n + 3), primitive_id(n / 2));
+                    add_triangle(vertex(n), vertex(n + 3), vertex(n + 2), primitive_id(n / 2));
+                }
+                break;
+            default:
+                break;
+        }
+
+        if(m_elements.empty()) return;
+        m_nodes.reserve(2 * (m_elements.size() / BVH_LEAF_SIZE + 1));
+        build_node(0, static_cast<uint32_t>(m_elements.size()));
+        m_bounds_min = m_nodes.front().min;
+        m_bounds_max = m_nodes.front().max;
+    }
+
+    void PrimitiveBVH::add_triangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const uint32_t sub_entity_id)
+    {
+        Element element;
+        element.v[0] = a; element.v[1] = b; element.v[2] = c;
+        element.min  = glm::min(a, glm::min(b, c));
+        element.max  = glm::max(a, glm::max(b, c));
+        element.radius = 0.0f;
+        element.sub_entity_id = sub_entity_id;
+        element.kind = TRIANGLE;
+        m_elements.push_back(element);
+    }
+
+    void PrimitiveBVH::add_segment(const glm::vec3& a, const glm::vec3& b, const uint32_t sub_entity_id, const float radius)
+    {
+        Element element;
+        element.v[0] = a; element.v[1] = element.v[2] = b;
+        element.min  = glm::min(a, b) - glm::vec3(radius);
+        element.max  = glm::max(a, b) + glm::vec3(radius);
+        element.radius = radius;
+        element.sub_entity_id = sub_entity_id;
+        element.kind = SEGMENT;
+        m_elements.push_back(element);
+    }
+
+    void PrimitiveBVH::add_point(const glm::vec3& a, const uint32_t sub_entity_id, const float radius)
+    {
+        Element element;
+        element.v[0] = element.v[1] = element.v[2] = a;
+        element.min  = a - glm::vec3(radius);
+        element.max  = a + glm::vec3(radius);
+        element.radius = radius;
+        element.sub_entity_id = sub_entity_id;
+        element.kind = POINT;
+        m_elements.push_back(element);
+    }
+
+    /// @brief Median split of the element centroids along the longest axis of their bounds
+    uint32_t PrimitiveBVH::build_node(const uint32_t first, const uint32_t count)
+    {
+        const uint32_t index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+
+        glm::vec3 min( std::numeric_limits<float>::max()), max(-std::numeric_limits<float>::max());
+        glm::vec3 centroid_min = min, centroid_max = max;
+        for(uint32_t i = first; i < first + count; ++i)
+        {
+            const Element& element = m_elements[i];
+            min = glm::min(min, element.min);
+            max = glm::max(max, element.max);
+            centroid_min = glm::min(centroid_min, element.min + element.max);
+            centroid_max = glm::max(centroid_max, element.min + element.max);
+        }
+        m_nodes[index].min = min;
+        m_nodes[index].max = max;
+
+        const glm::vec3 extent = centroid_max - centroid_min;
+        if(count <= BVH_LEAF_SIZE || (extent.x <= 0.0f && extent.y <= 0.0f && extent.z <= 0.0f))
+        {
+            m_nodes[index].first = first;
+            m_nodes[index].count = count;
+            m_nodes[index].right = 0;
+            return index;
+        }
+
+        const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+        const uint32_t half = count / 2;
+        std::nth_element(m_elements.begin() + first, m_elements.begin() + first + half, m_elements.begin() + first + count,
+                         [axis](const Element& a, const Element& b) { return a.min[axis] + a.max[axis] < b.min[axis] + b.max[axis]; });
+
+        build_node(first, half);
+        const uint32_t right = build_node(first + half, count - half);
+        m_nodes[index].first = first;
+        m_nodes[index].count = 0;
+        m_nodes[index].right = right;
+        return index;
+    }
+
+    const bool PrimitiveBVH::intersect(const PickRay& ray, float& distance, uint32_t& sub_entity_id) const
+    {
+        if(m_nodes.empty()) return false;
+
+        const glm::vec3 inverse_direction = 1.0f / ray.direction;
+        bool hit = false;
+
+        uint32_t stack[64];
+        uint32_t stack_size = 0;
+        stack[stack_size++] = 0;
+        while(stack_size > 0)
+        {
+            const Node& node = m_nodes[stack[--stack_size]];
+            if(!intersect_box(ray, inverse_direction, node.min, node.max, distance)) continue;
+
+            if(node.count > 0)
+            {
+                for(uint32_t i = node.first; i < node.first + node.count; ++i)
+                    if(intersect_element(m_elements[i], ray, distance)) { sub_entity_id = m_elements[i].sub_entity_id; hit = true; }
+                continue;
+            }
+            /// Median splits keep the depth at log2(elements / BVH_LEAF_SIZE), far below the stack size
+            stack[stack_size++] = node.right;
+            stack[stack_size++] = static_cast<uint32_t>(&node - m_nodes.data()) + 1;
+        }
+        return hit;
+    }
+
+    /// @brief Two sided triangle test (Moller Trumbore), closest approach of the ray to segments / points
+    const bool PrimitiveBVH::intersect_element(const Element& element, const PickRay& ray, float& distance) const
+    {
+        if(element.kind == TRIANGLE)
+        {
+            const glm::vec3 edge1 = element.v[1] - element.v[0];
+            const glm::vec3 edge2 = element.v[2] - element.v[0];
+            const glm::vec3 p = glm::cross(ray.direction, edge2);
+            const float determinant = glm::dot(edge1, p);
+            if(std::abs(determinant) < std::numeric_limits<float>::epsilon()) return false;
+
+            const float inverse_determinant = 1.0f / determinant;
+            const glm::vec3 s = ray.origin - element.v[0];
+            const float u = glm::dot(s, p) * inverse_determinant;
+            if(u < 0.0f || u > 1.0f) return false;
+            const glm::vec3 q = glm::cross(s, edge1);
+            const float v = glm::dot(ray.direction, q) * inverse_determinant;
+            if(v < 0.0f || u + v > 1.0f) return false;
+
+            const float t = glm::dot(edge2, q) * inverse_determinant;
+            if(t < 0.0f || t >= distance) return false;
+            distance = t;
+            return true;
+        }
+
+        float t = 0.0f;
+        glm::vec3 closest = element.v[0];
+        if(element.kind == SEGMENT)
+        {
+            /// Closest points of the ray and the segment, clamped to the segment and to the front of the ray
+            const glm::vec3 edge = element.v[1] - element.v[0];
+            const glm::vec3 w    = ray.origin - element.v[0];
+            const float b = glm::dot(ray.direction, edge);
+            const float c = glm::dot(edge, edge);
+            const float d = glm::dot(ray.direction, w);
+            const float e = glm::dot(edge, w);
+            const float denominator = c - b * b;
+            float s = (denominator > std::numeric_limits<float>::epsilon() * c) ? (e - b * d) / denominator : 0.0f;
+            s = glm::clamp(s, 0.0f, 1.0f);
+            t = std::max(0.0f, glm::dot(element.v[0] + s * edge - ray.origin, ray.direction));
+            if(c > 0.0f) s = glm::clamp(glm::dot(ray.origin + t * ray.direction - element.v[0], edge) / c, 0.0f, 1.0f);
+            closest = element.v[0] + s * edge;
+        }
+        else
+        {
+            t = glm::dot(element.v[0] - ray.origin, ray.direction);
+            if(t < 0.0f) return false;
+        }
+
+        const glm::vec3 offset = ray.origin + t * ray.direction - closest;
+        if(glm::dot(offset, offset) > element.radius * element.radius || t >= distance) return false;
+        distance = t;
+        return true;
+    }
+
+    /// @brief An element is outside if all its vertices are farther than its radius behind the same plane
+    void PrimitiveBVH::overlap(const PickFrustum& frustum, std::vector<uint32_t>& sub_entity_ids) const
+    {
+        if(m_nodes.empty()) return;
+
+        uint32_t stack[64];
+        uint32_t stack_size = 0;
+        stack[stack_size++] = 0;
+        while(stack_size > 0)
+        {
+            const uint32_t index = stack[--stack_size];
+            const Node& node = m_nodes[index];
+            if(!overlap_box(frustum, node.min, node.max)) continue;
+
+            if(node.count == 0)
+            {
+                stack[stack_size++] = node.right;
+                stack[stack_size++] = index + 1;
+                continue;
+            }
+
+            for(uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                const Element& element = m_elements[i];
+                const int vertices = element.kind == TRIANGLE ? 3 : (element.kind == SEGMENT ? 2 : 1);
+                bool inside = true;
+                for(const glm::vec4& plane : frustum.planes)
+                {
+                    bool all_outside = true;
+                    for(int v = 0; v < vertices && all_outside; ++v)
+                        all_outside = glm::dot(glm::vec3(plane), element.v[v]) + plane.w < -element.radius;
+                    if(all_outside) { inside = false; break; }
+                }
+                if(inside) sub_entity_ids.push_back(element.sub_entity_id);
+            }
+        }
+    }
+
+    /// @brief Entities are built independently, so workers take the next unbuilt source until none is left
+    void RayPickEngine::build(const std::vector<Source>& sources, const size_t num_threads)
+    {
+        for(const Source& source : sources)
+            if(source.descriptor == nullptr || source.descriptor->currentPrimitiveSet == nullptr)
+                throw std::runtime_error("RayPickEngine : entity " + std::to_string(source.entity_id) + " has no primitive set");
+
+        m_entities.clear();
+        m_entities.resize(sources.size());
+
+        const size_t hardware_threads = std::thread::hardware_concurrency();
+        size_t worker_count = num_threads != 0 ? num_threads : std::max<size_t>(1, hardware_threads);
+        worker_count = std::min(worker_count, sources.size());
+
+        std::atomic<size_t> next_source(0);
+        std::vector<std::string> errors(sources.size());
+        auto worker = [&]()
+        {
+            for(size_t i = next_source++; i < sources.size(); i = next_source++)
+            {
+                const GeometryDescriptor::PrimitiveSetInstance& primitive_set = *sources[i].descriptor->currentPrimitiveSet;
+                EntityBVH& entity = m_entities[i];
+                entity.entity_id       = sources[i].entity_id;
+                entity.instance_stride = static_cast<uint32_t>(primitive_set.get_pickable_entities_per_instance());
+
+                /// Instance transforms apply in entity space, before the world matrix (as in the instanced shaders)
+                const std::vector<float>& instance_transforms = primitive_set.get_instance_transforms();
+                const size_t instances = std::max<size_t>(1, primitive_set.get_num_instances());
+                entity.placements.resize(instances);
+                for(size_t n = 0; n < instances; ++n)
+                {
+                    Placement& placement = entity.placements[n];
+                    placement.world         = primitive_set.is_instanced() ? sources[i].world * glm::make_mat4(&instance_transforms[n * 16]) : sources[i].world;
+                    placement.transformed   = placement.world != glm::mat4(1.0f);
+                    placement.inverse_world = placement.transformed ? glm::inverse(placement.world) : glm::mat4(1.0f);
+                }
+
+                try                             { entity.bvh.build(primitive_set, m_line_tolerance, m_point_radius); }
+                catch(const std::exception& e)  { errors[i] = e.what(); }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for(size_t i = 1; i < worker_count; ++i) workers.emplace_back(worker);
+        worker();
+        for(std::thread& thread : workers) thread.join();
+
+        for(size_t i = 0; i < errors.size(); ++i)
+            if(!errors[i].empty())
+            {
+                m_entities.clear();
+                throw std::runtime_error("RayPickEngine : entity " + std::to_string(sources[i].entity_id) + " : " + errors[i]);
+            }
+    }
+
+    /// @brief Entities whose bounds the ray enters beyond the current nearest hit are skipped
+    const bool RayPickEngine::ray_pick(const PickRay& ray, RayPickHit& hit) const
+    {
+        const glm::vec3 inverse_direction = 1.0f / ray.direction;
+        float distance = std::numeric_limits<float>::max();
+        bool found = false;
+
+        for(const EntityBVH& entity : m_entities)
+        {
+            if(entity.bvh.empty()) continue;
+
+            for(size_t instance = 0; instance < entity.placements.size(); ++instance)
+            {
+                const Placement& placement = entity.placements[instance];
+                /// Instances follow each other in the id space of the entity, like in the instanced pick shaders
+                const uint32_t sub_entity_base = static_cast<uint32_t>(instance) * entity.instance_stride;
+
+                if(!placement.transformed)
+                {
+                    if(!intersect_box(ray, inverse_direction, entity.bvh.bounds_min(), entity.bvh.bounds_max(), distance)) continue;
+                    uint32_t sub_entity_id = 0;
+                    if(entity.bvh.intersect(ray, distance, sub_entity_id))
+                    {
+                        hit.entity_id     = entity.entity_id;
+                        hit.sub_entity_id = sub_entity_base + sub_entity_id;
+                        hit.distance      = distance;
+                        found = true;
+                    }
+                    continue;
+                }
+
+                /// Local ray : a distance t along the (unit) scene ray is t * scale along the normalised local ray
+                const glm::vec3 local_direction = glm::vec3(placement.inverse_world * glm::vec4(ray.direction, 0.0f));
+                const float scale = glm::length(local_direction);
+                if(scale <= 0.0f) continue;
+
+                PickRay local_ray;
+                local_ray.origin    = glm::vec3(placement.inverse_world * glm::vec4(ray.origin, 1.0f));
+                local_ray.direction = local_direction / scale;
+
+                float local_distance = distance < std::numeric_limits<float>::max() ? distance * scale : distance;
+                if(!intersect_box(local_ray, 1.0f / local_ray.direction, entity.bvh.bounds_min(), entity.bvh.bounds_max(), local_distance)) continue;
+                uint32_t sub_entity_id = 0;
+                if(entity.bvh.intersect(local_ray, local_distance, sub_entity_id))
+                {
+                    distance          = local_distance / scale;
+                    hit.entity_id     = entity.entity_id;
+                    hit.sub_entity_id = sub_entity_base + sub_entity_id;
+                    hit.distance      = distance;
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }
+
+    std::vector<PickSelection> RayPickEngine::frustum_pick(const PickFrustum& frustum) const
+    {
+        std::vector<PickSelection> selection;
+        std::vector<uint32_t> sub_entity_ids;
+        for(const EntityBVH& entity : m_entities)
+        {
+            if(entity.bvh.empty()) continue;
+
+            sub_entity_ids.clear();
+            for(size_t instance = 0; instance < entity.placements.size(); ++instance)
+            {
+                const Placement& placement = entity.placements[instance];
+
+                /// Planes move to the local space with the transpose of the world matrix
+                PickFrustum local_frustum = frustum;
+                if(placement.transformed)
+                {
+                    const glm::mat4 world_transpose = glm::transpose(placement.world);
+                    for(glm::vec4& plane : local_frustum.planes) plane = normalise_plane(world_transpose * plane);
+                }
+                if(!overlap_box(local_frustum, entity.bvh.bounds_min(), entity.bvh.bounds_max())) continue;
+
+                const size_t first = sub_entity_ids.size();
+                entity.bvh.overlap(local_frustum, sub_entity_ids);
+                const uint32_t sub_entity_base = static_cast<uint32_t>(instance) * entity.instance_stride;
+                for(size_t i = first; i < sub_entity_ids.size(); ++i) sub_entity_ids[i] += sub_entity_base;
+            }
+
+            /// Split quads and PICK_GEOMETRY report the same id several times
+            std::sort(sub_entity_ids.begin(), sub_entity_ids.end());
+            sub_entity_ids.erase(std::unique(sub_entity_ids.begin(), sub_entity_ids.end()), sub_entity_ids.end());
+            for(const uint32_t sub_entity_id : sub_entity_ids) selection.push_back(PickSelection{entity.entity_id, sub_entity_id});
+        }
+        std::sort(selection.begin(), selection.end(), [](const PickSelection& a, const PickSelection& b)
+                  { return a.entity_id < b.entity_id || (a.entity_id == b.entity_id && a.sub_entity_id < b.sub_entity_id); });
+        return selection;
+    }
+
+    /// @brief Unproject the cursor on the near and far planes through inverse(projection * view * model)
+    PickRay RayPickEngine::ray_from_cursor(const SceneState& scene_state, const float x, const float y, const glm::vec4& viewport)
+    {
+        const glm::mat4 inverse_mvp = glm::inverse(scene_state.m_projection * scene_state.m_view * scene_state.m_model);
+        const glm::vec2 ndc = cursor_to_ndc(x, y, viewport);
+
+        glm::vec4 near_point = inverse_mvp * glm::vec4(ndc, -1.0f, 1.0f);
+        glm::vec4 far_point  = inverse_mvp * glm::vec4(ndc,  1.0f, 1.0f);
+        near_point /= near_point.w;
+        far_point  /= far_point.w;
+
+        PickRay ray;
+        ray.origin    = glm::vec3(near_point);
+        ray.direction = glm::normalize(glm::vec3(far_point - near_point));
+        return ray;
+    }
+
+    /// @brief Clip space bounds of the rectangle as planes of projection * view * model (Gribb / Hartmann extraction)
+    PickFrustum RayPickEngine::frustum_from_rectangle(const SceneState& scene_state, const float x0, const float y0, const float x1, const float y1, const glm::vec4& viewport)
+    {
+        const glm::mat4 mvp = scene_state.m_projection * scene_state.m_view * scene_state.m_model;
+        const glm::vec2 a = cursor_to_ndc(x0, y0, viewport);
+        const glm::vec2 b = cursor_to_ndc(x1, y1, viewport);
+        const glm::vec2 ndc_min = glm::min(a, b);
+        const glm::vec2 ndc_max = glm::max(a, b);
+
+        const glm::vec4 row_x = matrix_row(mvp, 0), row_y = matrix_row(mvp, 1), row_z = matrix_row(mvp, 2), row_w = matrix_row(mvp, 3);
+
+        PickFrustum frustum;
+        frustum.planes[0] = normalise_plane(row_x - ndc_min.x * row_w);
+        frustum.planes[1] = normalise_plane(ndc_max.x * row_w - row_x);
+        frustum.planes[2] = normalise_plane(row_y - ndc_min.y * row_w);
+        frustum.planes[3] = normalise_plane(ndc_max.y * row_w - row_y);
+        frustum.planes[4] = normalise_plane(row_w + row_z);
+        frustum.planes[5] = normalise_plane(row_w - row_z);
+        return frustum;
+    }
+}
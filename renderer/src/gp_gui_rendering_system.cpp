@@ -6,7 +6,13 @@
 #include "gp_gui_opengl_3_3_render_kernel.h"
 #include "gp_gui_communications.h"
 #include "gp_gui_instrumentation.h"
+#include "gp_gui_streaming_uploader.h"
+#include "gp_gui_gl_state_cache.h"
+#include "gp_gui_scene_uniform_buffer.h"
 #include <iostream>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 
 namespace gridpro_gui {
@@ -15,14 +21,46 @@ void OpenGL_3_3_RenderSystem::update(float layer)
 {
     Instrumentation::Stopwatch watch("OpenGL_3_3_RenderSystem::update");
     DEBUG_PRINT("Entities count = ",  entities().count() , "\n");
-    
+
+    /// Qt may touch the GL state between frames, so the cache starts every frame unknown
+    GLStateCache::GetInstance().invalidate();
+
+    /// Scene matrices are uploaded once for all the draws of the frame (SceneBlock uniform block)
+    SceneUniformBuffer::GetInstance().update(Event::Publisher::GetInstance()->get_scene_state());
+
+    framebuffer* frame_buffer = Event::Publisher::GetInstance()->frame_buffer();
+
+    /// The offscreen id image is only re-rendered when one of its inputs changed, otherwise the cached image answers picks.
+    /// The RGB pick pass draws into the visible back buffer, so it runs every frame.
+    m_selection_scheduler.begin(Event::Publisher::GetInstance()->get_scene_state(), frame_buffer->pick_pass_signature());
     for(auto Entity : entities().with<OpenGL_3_3_RenderKernel>())
-    { 
-        auto& render_kernel = Entity.get<OpenGL_3_3_RenderKernel>();
-        render_kernel.render_selection_mode();
+        m_selection_scheduler.accumulate(Entity.get<OpenGL_3_3_RenderKernel>().get_pick_signature());
+    const bool render_pick_pass = m_selection_scheduler.end() || frame_buffer->get_pick_target() != framebuffer::PickTarget::INTEGER_ID_FBO;
+    if(!render_pick_pass)
+    {
+        frame_buffer->poll_pending_readbacks();
+        StreamingUploader::GetInstance().end_frame();
+        return;
     }
 
-    Event::Publisher::GetInstance()->frame_buffer()->update_current_frame_buffer();   
+    /// Fixes the pick region of this frame (scissors the draws to it in region of interest mode)
+    const SceneState& scene_state = Event::Publisher::GetInstance()->get_scene_state();
+    frame_buffer->begin_pick_pass(scene_state.m_projection * scene_state.m_view);
+
+    /// A depth peeled pass draws the scene once per layer, it stops at the first layer without any id
+    const uint32_t pick_layers = frame_buffer->pick_layer_count();
+    for(uint32_t layer = 0; layer < pick_layers; ++layer)
+    {
+        frame_buffer->begin_peel_layer(layer);
+        render_pick_layer();
+        if(!frame_buffer->end_peel_layer(layer)) break;
+    }
+
+    GLStateCache::GetInstance().restore_defaults();
+
+    StreamingUploader::GetInstance().end_frame();
+
+    frame_buffer->update_current_frame_buffer();   
     
     // for(auto Entity : entities().with<OpenGL_3_3_RenderKernel>())
     // { 
@@ -31,4 +69,35 @@ void OpenGL_3_3_RenderSystem::update(float layer)
     // }
 }
 
+/// @brief Draw every pickable entity once into the current pick target
+void OpenGL_3_3_RenderSystem::render_pick_layer()
+{
+    /// Individually drawn kernels are sorted by program / rasteriser state so that consecutive draws share their state
+    std::vector<std::pair<uint64_t, OpenGL_3_3_RenderKernel*>> sorted_draws;
+    sorted_draws.reserve(entities().count());
+    
+#ifdef _ENABLE_BATCHED_RENDER_PATH_
+    /// Arena backed entities are drawn in multi draw batches, the rest fall back to their own draw calls
+    m_batched_path.begin(true);
+    for(auto Entity : entities().with<OpenGL_3_3_RenderKernel>())
+    { 
+        auto& render_kernel = Entity.get<OpenGL_3_3_RenderKernel>();
+        if(!m_batched_path.submit(render_kernel))
+            sorted_draws.emplace_back(render_kernel.get_draw_sort_key(true), &render_kernel);
+    }
+    m_batched_path.flush();
+#else
+    for(auto Entity : entities().with<OpenGL_3_3_RenderKernel>())
+    { 
+        auto& render_kernel = Entity.get<OpenGL_3_3_RenderKernel>();
+        sorted_draws.emplace_back(render_kernel.get_draw_sort_key(true), &render_kernel);
+    }
+#endif
+
+    std::stable_sort(sorted_draws.begin(), sorted_draws.end(),
+                     [](const std::pair<uint64_t, OpenGL_3_3_RenderKernel*>& a, const std::pair<uint64_t, OpenGL_3_3_RenderKernel*>& b) { return a.first < b.first; });
+    for(auto& draw : sorted_draws)
+        draw.second->render_selection_mode();
+}
+
 } // namespace gridpro_gui    
@@ -8,11 +8,15 @@
 #include "gp_gui_debug.h"
 #include "gp_gui_shader.h"
 #include "gp_gui_shader_src.h"
+#include "gp_gui_commit_pipeline.h"
+#include "gp_gui_vertex_array_object.h"
+#include <algorithm>
 
 namespace gridpro_gui 
 {
  
-Gp_gui_scene::Gp_gui_scene() : RenderSystemsManager(RenderableEntitiesManager) , PublisherInstance(Event::Publisher::GetInstance())
+Gp_gui_scene::Gp_gui_scene() : Transforms(Entity_DataBase), RenderSystemsManager(RenderableEntitiesManager) , color_id_allocator(GL_PICK_ID_BASE), PublisherInstance(Event::Publisher::GetInstance()),
+                               CommitPipeline(nullptr), color_reservation_tombstones(0), m_view_projection(1.0f), m_inverse_view_projection(1.0f), m_commit_budget_ms(GL_COMMIT_BUDGET_MS)
 {
    // Critical Do not remove this line  !!!
    PublisherInstance->set_scene_ptr(this); 
@@ -24,6 +28,16 @@ Gp_gui_scene::Gp_gui_scene() : RenderSystemsManager(RenderableEntitiesManager) ,
         ShaderLibrary::AddShader("BasicShader", ShaderSrc::BasicVertexShaderSource, ShaderSrc::BasicFragmentShaderSource);
         ShaderLibrary::AddShader("SelectGeometryShader", ShaderSrc::SelectGeometryVertexShaderSource, ShaderSrc::SelectGeometryFragmentShaderSource);
         ShaderLibrary::AddShader("SelectPrimitiveShader", ShaderSrc::SelectPrimitiveVertexShaderSource, ShaderSrc::SelectPrimitiveFragmentShaderSource);
+        ShaderLibrary::AddShader("BatchedBasicShader", ShaderSrc::BatchedBasicVertexShaderSource, ShaderSrc::BatchedBasicFragmentShaderSource);
+        ShaderLibrary::AddShader("BatchedSelectGeometryShader", ShaderSrc::BatchedSelectVertexShaderSource, ShaderSrc::BatchedSelectGeometryFragmentShaderSource);
+        ShaderLibrary::AddShader("BatchedSelectPrimitiveShader", ShaderSrc::BatchedSelectVertexShaderSource, ShaderSrc::BatchedSelectPrimitiveFragmentShaderSource);
+        ShaderLibrary::AddShader("IdSelectGeometryShader", ShaderSrc::SelectGeometryVertexShaderSource, ShaderSrc::IdSelectGeometryFragmentShaderSource);
+        ShaderLibrary::AddShader("IdSelectPrimitiveShader", ShaderSrc::SelectPrimitiveVertexShaderSource, ShaderSrc::IdSelectPrimitiveFragmentShaderSource);
+        ShaderLibrary::AddShader("BatchedIdSelectGeometryShader", ShaderSrc::BatchedSelectVertexShaderSource, ShaderSrc::BatchedIdSelectGeometryFragmentShaderSource);
+        ShaderLibrary::AddShader("BatchedIdSelectPrimitiveShader", ShaderSrc::BatchedSelectVertexShaderSource, ShaderSrc::BatchedIdSelectPrimitiveFragmentShaderSource);
+        ShaderLibrary::AddShader("InstancedBasicShader", ShaderSrc::InstancedBasicVertexShaderSource, ShaderSrc::BatchedBasicFragmentShaderSource);
+        ShaderLibrary::AddShader("InstancedSelectShader", ShaderSrc::InstancedSelectVertexShaderSource, ShaderSrc::InstancedSelectFragmentShaderSource);
+        ShaderLibrary::AddShader("InstancedIdSelectShader", ShaderSrc::InstancedSelectVertexShaderSource, ShaderSrc::InstancedIdSelectFragmentShaderSource);
    }
 
    catch(const std::exception& e)
@@ -53,21 +67,91 @@ void Gp_gui_scene::update(const float& layer)
      return;
    }
 
-    update_color_reservations();
+    if(CommitPipeline) CommitPipeline->flush(*this, m_commit_budget_ms);
+
+    /// Pick ids are reserved incrementally by the render kernels (reserve_color_ids), nothing to do for unchanged entities
     RenderSystemsManager.update(layer);
 
     uint32_t color_id =  scene_subscription.getPickEvent().getColorID();
-    if((color_id) != 0 && color_id <=  last_color_id)
+    const unique_color_reservation* reservation = (color_id != 0 && color_id <= last_color_id) ? find_color_reservation(color_id) : nullptr;
+    if(reservation != nullptr)
     {
-      scene_subscription.getPickEvent().setEntityKey(EntityIdxKeyMapRegistry[get_actual_id(color_id)]);
-      scene_subscription.getPickEvent().setEntityID(get_actual_id(color_id));
-      scene_subscription.getPickEvent().setSubEntityID(color_id - (unique_colr_reservations[get_actual_id(color_id)]._Min_ColorID_));
+      scene_subscription.getPickEvent().setEntityKey(get_entity_key(reservation->_EntityID_));
+      scene_subscription.getPickEvent().setEntityID(reservation->_EntityID_);
+      scene_subscription.getPickEvent().setSubEntityID(color_id - reservation->_Min_ColorID_);
     }
   
     DEBUG_PRINT("Updated");
 
 }
 
+/// @brief Bulk commit (project loading)
+/// @details Packing runs here on the calling thread, use commit_async() to move it to the worker pool instead
+std::vector<Gp_gui_entity_handle> Gp_gui_scene::commit_batch(const EntityCommit* commits, const size_t count)
+{
+    std::vector<std::shared_ptr<VertexArrayObject>> staged_vaos(count);
+    std::vector<VertexArrayObject*> uploads(count);
+
+    /// Validate and pack everything first so a bad descriptor leaves the scene untouched
+    for(size_t i = 0; i < count; ++i)
+    {
+        const std::shared_ptr<GeometryDescriptor>& descriptor = commits[i].second;
+        if(descriptor == nullptr) throw std::runtime_error("Commit of " + commits[i].first + " failed : descriptor is null");
+        try
+        {
+            descriptor->isValid();
+            staged_vaos[i] = std::make_shared<VertexArrayObject>();
+            staged_vaos[i]->stage(descriptor.get());
+        }
+        catch(const std::exception& e)
+        {
+            throw std::runtime_error("Commit of " + commits[i].first + " failed : " + e.what());
+        }
+        uploads[i] = staged_vaos[i].get();
+    }
+
+    VertexArrayObject::upload_staged_batch(uploads);
+
+    EntityKeyTable::GetInstance().reserve(count);
+    const size_t expected = SceneEntityRegistry.size() + count;
+    SceneEntityRegistry.reserve(expected);
+    EntityIdxKeyMapRegistry.reserve(expected);
+    unique_colr_reservations.reserve(expected);
+    color_reservation_table.reserve(expected);
+    Entity_DataBase.reserve(count);
+
+    std::vector<Gp_gui_entity_handle> handles;
+    handles.reserve(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        handles.push_back(get_entity(commits[i].first));
+        handles.back().GetComponent<OpenGL_3_3_RenderKernel>()->set_geometry_descriptor(commits[i].second, staged_vaos[i]);
+    }
+    return handles;
+}
+
+std::vector<Gp_gui_entity_handle> Gp_gui_scene::commit_batch(const std::vector<EntityCommit>& commits)
+{
+    return commit_batch(commits.data(), commits.size());
+}
+
+/// @brief Commit a descriptor asynchronously
+/// @param entity_key
+/// @param descriptor
+/// @details  Validation and packing run on the worker pool, the GL upload runs in a later update() within the commit budget
+/// @note Do not modify the descriptor until pending_commits() no longer counts it
+void Gp_gui_scene::commit_async(const std::string& entity_key, const std::shared_ptr<GeometryDescriptor>& descriptor)
+{
+    /// The worker threads are only started once a scene actually commits asynchronously
+    if(!CommitPipeline) CommitPipeline.reset(new GeometryCommitPipeline());
+    CommitPipeline->submit(entity_key, descriptor);
+}
+
+size_t Gp_gui_scene::pending_commits() const
+{
+    return CommitPipeline ? CommitPipeline->pending() : 0;
+}
+
 void Gp_gui_scene::update_mouse_event(const float& x, const float& y)
 {
    MouseEvent mouse_event;
@@ -82,6 +166,9 @@ void Gp_gui_scene::update_mouse_event(const float& x, const float& y)
         PublisherInstance->GlobalMouseEvent.pop_back();
    }
  
+  /// @brief  The next pick pass only renders / reads back the window around the cursor (region of interest mode)
+  PublisherInstance->frame_buffer()->request_region_of_interest(x, y);
+
   /// @brief  Get the pick event and update it
   Event::Subscription scene_subscription("scene");
   uint32_t color_id =  PublisherInstance->frame_buffer()->color_id_at(x,y);
@@ -89,22 +176,27 @@ void Gp_gui_scene::update_mouse_event(const float& x, const float& y)
 
   scene_subscription.getPickEvent().setColorID(0);
   scene_subscription.getPickEvent().SetEventType(EventType::None);
-  scene_subscription.getPickEvent().setEntityKey("NULL_ENTITY");
+  scene_subscription.getPickEvent().setEntityKey(INVALID_ENTITY_KEY);
   scene_subscription.getPickEvent().setDepth(PublisherInstance->frame_buffer()->depth_at(x,y));
+  scene_subscription.getPickEvent().setSurface(glm::vec3(0.0f), glm::vec3(0.0f), false);
 
   if(!get_scene_state().is_render_systems_enabled()) 
   {  
      return;
   }
 
-  if((color_id) != 0 && color_id <=  last_color_id)
+  const unique_color_reservation* reservation = (color_id != 0 && color_id <= last_color_id) ? find_color_reservation(color_id) : nullptr;
+  if(reservation != nullptr)
   {
     scene_subscription.getPickEvent().setColorID(color_id);
     scene_subscription.getPickEvent().SetEventType(EventType::PickedEntity);
-    scene_subscription.getPickEvent().setEntityKey(EntityIdxKeyMapRegistry[get_actual_id(color_id)]);
-    scene_subscription.getPickEvent().setEntityID(get_actual_id(color_id));
-    scene_subscription.getPickEvent().setSubEntityID(color_id - (unique_colr_reservations[get_actual_id(color_id)]._Min_ColorID_));
+    scene_subscription.getPickEvent().setEntityKey(get_entity_key(reservation->_EntityID_));
+    scene_subscription.getPickEvent().setEntityID(reservation->_EntityID_);
+    scene_subscription.getPickEvent().setSubEntityID(color_id - reservation->_Min_ColorID_);
     scene_subscription.getPickEvent().setDepth(depth);  
+
+    const framebuffer::SurfaceSample surface = PublisherInstance->frame_buffer()->last_hit_surface(PublisherInstance->frame_buffer()->image_inverse_view_projection());
+    scene_subscription.getPickEvent().setSurface(surface.position, surface.normal, surface.hit);
   }
 }
 
@@ -114,15 +206,20 @@ void Gp_gui_scene::update_mouse_event(const float& x, const float& y)
 /// @details  Use this function to check if the entity exists in the scene
 bool Gp_gui_scene::has_entity(const std::string& entity_key)
 {
-    std::unordered_map<std::string, uint32_t>::iterator it  = this->SceneEntityRegistry.find(entity_key); 
-    if( it != SceneEntityRegistry.end() )
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+    /// find() does not intern, unknown keys do not grow the key table
+    return has_entity(EntityKeyTable::GetInstance().find(entity_key));
+}
+
+bool Gp_gui_scene::has_entity(const EntityKey entity_key)
+{
+    return SceneEntityRegistry.find(entity_key) != SceneEntityRegistry.end();
+}
+
+/// @brief Interned key of an entity id (INVALID_ENTITY_KEY if the id is not in the scene)
+EntityKey Gp_gui_scene::get_entity_key(const uint32_t entity_id) const
+{
+    std::unordered_map<uint32_t, EntityKey>::const_iterator it = EntityIdxKeyMapRegistry.find(entity_id);
+    return it != EntityIdxKeyMapRegistry.end() ? it->second : INVALID_ENTITY_KEY;
 }
 
 
@@ -134,14 +231,21 @@ bool Gp_gui_scene::has_entity(const std::string& entity_key)
 /// @details  Use this function to get the entity object from the scene
 Gp_gui_entity_handle Gp_gui_scene::get_entity(const std::string& entity_key)
 {
+    return get_entity(EntityKeyTable::GetInstance().intern(entity_key));
+}
+
+Gp_gui_entity_handle Gp_gui_scene::get_entity(const EntityKey entity_key)
+{
+if(entity_key == INVALID_ENTITY_KEY) throw std::runtime_error("Entity key is not valid");
+
 // Check if key exists
-std::unordered_map<std::string, uint32_t>::iterator it  = this->SceneEntityRegistry.find(entity_key); 
+std::unordered_map<EntityKey, uint32_t>::iterator it  = this->SceneEntityRegistry.find(entity_key); 
 
 // If key Exists Retrieve it
 if( it != SceneEntityRegistry.end() )
 {
     Gp_gui_entity_handle entt_handle;
-    entt_handle.entity_ptr = &Entity_DataBase[SceneEntityRegistry[entity_key]];
+    entt_handle.entity_slot = Entity_DataBase.handle(it->second);
     entt_handle.scene_ptr = this;
     entt_handle.entity_key = entity_key; 
     
@@ -150,29 +254,29 @@ if( it != SceneEntityRegistry.end() )
 // Else Create a new one
 else
 {   
-    DEBUG_PRINT("Creating Entity : ", entity_key);
+    DEBUG_PRINT("Creating Entity : ", EntityKeyTable::GetInstance().str(entity_key));
     DEBUG_PRINT("Total Entity Count : ", (Entity_DataBase.size()));
 
-    uint32_t curr_assign_id = (Entity_DataBase.size());
+    // Create and store entity in a slot of the entity store, the slot is the entity id
+    const SlotHandle slot = Entity_DataBase.insert(this->RenderableEntitiesManager.create());
+    const uint32_t curr_assign_id = slot.slot;
 
     // Register the Entity key-idx pairs
     SceneEntityRegistry[entity_key] = curr_assign_id; /// store Entity key index pair in registry 
     EntityIdxKeyMapRegistry[curr_assign_id] = entity_key;
 
-    // Create and store entity in the entity deque
-    Entity_DataBase.emplace_back(this->RenderableEntitiesManager.create());
-    
     // Add a geometry descriptor Component to the entity
-    Entity_DataBase.back().add<OpenGL_3_3_RenderKernel>();
-    Entity_DataBase.back().get<OpenGL_3_3_RenderKernel>().set_kernel_id(curr_assign_id);
+    ecs::Entity& entity = *Entity_DataBase.get(slot);
+    entity.add<OpenGL_3_3_RenderKernel>();
+    entity.get<OpenGL_3_3_RenderKernel>().set_kernel_id(curr_assign_id);
 
     // Create a indirect EntityHandle and return it
     Gp_gui_entity_handle entt_handle;
-    entt_handle.entity_ptr =  &(Entity_DataBase.back()); 
+    entt_handle.entity_slot = slot; 
     entt_handle.scene_ptr = this;
     entt_handle.entity_key = entity_key;
     
-    DEBUG_PRINT("Success in Entity Creation : ", entity_key);
+    DEBUG_PRINT("Success in Entity Creation : ", EntityKeyTable::GetInstance().str(entity_key));
     
     return entt_handle;
 }
@@ -183,97 +287,244 @@ else
 /// @param entity_key
 /// @return bool
 /// @details  Use this function to remove the entity from the scene
+/// @details  O(1) : the last entity takes the dense position of the removed one, the other entity ids (slots) are unchanged
 bool Gp_gui_scene::remove_entity_from_registry(const std::string& entity_key)
 {
-// Reassigning IDs 
-std::unordered_map<std::string, uint32_t>::iterator idx = SceneEntityRegistry.begin();
-while(idx !=  SceneEntityRegistry.end())
-{
-    if(idx->second > SceneEntityRegistry[entity_key])
-    {
-        --(idx->second);
-    }
-    ++idx;
+    return remove_entity_from_registry(EntityKeyTable::GetInstance().find(entity_key));
 }
- 
-std::deque<ecs::Entity>::iterator it = Entity_DataBase.begin();
 
-while ((*it != (Entity_DataBase[SceneEntityRegistry[entity_key]])))
+bool Gp_gui_scene::remove_entity_from_registry(const EntityKey entity_key)
 {
-     if(it == Entity_DataBase.end()) break;
-    ++it;
-}
+std::unordered_map<EntityKey, uint32_t>::iterator it = SceneEntityRegistry.find(entity_key);
+if(it == SceneEntityRegistry.end()) return false;
+
+const uint32_t removed_id = it->second;
+ecs::Entity* entity = Entity_DataBase.get(removed_id);
+if(entity == nullptr) return false;
 
-if(it != Entity_DataBase.end())
+// Children of the entity become roots, then the render kernel is destroyed so the render systems no longer see the entity
+Transforms.remove(removed_id);
+entity->destroy();
+Entity_DataBase.erase(removed_id);
+
+std::unordered_map<uint32_t, unique_color_reservation>::iterator reservation = unique_colr_reservations.find(removed_id);
+if(reservation != unique_colr_reservations.end())
 {
-    Entity_DataBase.erase(it);
-    EntityIdxKeyMapRegistry.erase(SceneEntityRegistry[entity_key]);
-    unique_colr_reservations.erase(SceneEntityRegistry[entity_key]);
-    SceneEntityRegistry.erase(entity_key);
-    return true;
+    /// The ids go back to the free-list for the next reservation
+    color_id_allocator.release(reservation->second._Min_ColorID_, reservation->second._Max_ColorID_ - reservation->second._Min_ColorID_ + 1);
+    retire_color_reservation(removed_id);
+    unique_colr_reservations.erase(reservation);
 }
 
-return false;
+EntityIdxKeyMapRegistry.erase(removed_id);
+SceneEntityRegistry.erase(it);
+return true;
 }
 
+/// @brief Turn the table entry of the entity into a tombstone (O(log n), the table is not shifted)
+void Gp_gui_scene::retire_color_reservation(const uint32_t entity_id)
+{
+  const unique_color_reservation& current = unique_colr_reservations[entity_id];
+  std::vector<unique_color_reservation>::iterator entry =
+      std::lower_bound(color_reservation_table.begin(), color_reservation_table.end(), current._Min_ColorID_,
+                       [](const unique_color_reservation& reservation, const uint32_t id) { return reservation._Min_ColorID_ < id; });
+  if(entry == color_reservation_table.end() || entry->_EntityID_ != entity_id) return;
+
+  /// An empty interval (max < min) matches no color id
+  entry->_Max_ColorID_ = 0;
+  ++color_reservation_tombstones;
+}
 
+/// @brief Remove every tombstone in one pass
+void Gp_gui_scene::drop_color_reservation_tombstones()
+{
+  if(color_reservation_tombstones == 0) return;
+  color_reservation_table.erase(std::remove_if(color_reservation_table.begin(), color_reservation_table.end(),
+                                               [](const unique_color_reservation& reservation) { return reservation._Max_ColorID_ < reservation._Min_ColorID_; }),
+                                color_reservation_table.end());
+  color_reservation_tombstones = 0;
+}
 
 /// @brief Update the color reservations
-/// @details  Use this function to update the color reservations
-/// @note This function is called before the scene is updated so that pick ids are reserved for each entity properly
+/// @details  Reassigns the pick ids of every entity from scratch in entity order (compacts the id space)
+/// @note Reservations are otherwise maintained incrementally by reserve_color_ids(), so this is not needed per frame
 void Gp_gui_scene::update_color_reservations()
 {
-  std::deque<ecs::Entity>::iterator end = Entity_DataBase.end();
+  SlotMap<ecs::Entity>::iterator end = Entity_DataBase.end();
   
-  std::deque<ecs::Entity>::iterator it  = Entity_DataBase.begin();
+  SlotMap<ecs::Entity>::iterator it  = Entity_DataBase.begin();
 
-  uint32_t reserved_color_id_end  = 1000000;
+  color_id_allocator.reset();
+  unique_colr_reservations.clear();
+  color_reservation_table.clear();
+  color_reservation_table.reserve(Entity_DataBase.size());
+  color_reservation_tombstones = 0;
 
   for(it; it != end; ++it)
      {
+       // get entity's mesh component
+       GeometryDescriptor* Mesh =  (it->get<OpenGL_3_3_RenderKernel>().get_descriptor().get());
+       if(Mesh == nullptr) continue;
+
        // Temporary Color reservation
        unique_color_reservation  colr_reserv;
 
-       // Set its Minima of color id based on previous entity max color id
-       colr_reserv._Min_ColorID_ = reserved_color_id_end;
-       
-       // get entity's mesh component
-       GeometryDescriptor* Mesh =  (it->get<OpenGL_3_3_RenderKernel>().get_descriptor().get());
-       
        // set color reservation id so that we can know to whom the reservation belongs to 
        colr_reserv._EntityID_ = it->get<OpenGL_3_3_RenderKernel>().get_kernel_id();     
-       
-       // Based on previous entitiy mac color id,  let the mesh calculate how many ids it needs
-       Mesh->set_color_id_reserve_start(reserved_color_id_end);
-       
-       // reflect the same in the color reservation component
+
+       // Ids are handed out in entity order, so the table comes out sorted by _Min_ColorID_
+       colr_reserv._Min_ColorID_ = color_id_allocator.allocate(Mesh->get_color_id_reserve_count());
+       Mesh->set_color_id_reserve_start(colr_reserv._Min_ColorID_);
        colr_reserv._Max_ColorID_ = Mesh->get_color_id_reserve_end();
 
-       // After the mesh calculates the required ids by the current mesh set minima for next entity as max of previous entity  
-       reserved_color_id_end = colr_reserv._Max_ColorID_ + 1;
-    
        unique_colr_reservations[colr_reserv._EntityID_] = colr_reserv;
+       color_reservation_table.push_back(colr_reserv);
 
-       DEBUG_PRINT("RESERVED IDS for Entity" , EntityIdxKeyMapRegistry[colr_reserv._EntityID_] , " = " , colr_reserv._Min_ColorID_ , ", " , colr_reserv._Max_ColorID_ );  
+       DEBUG_PRINT("RESERVED IDS for Entity" , EntityKeyTable::GetInstance().str(get_entity_key(colr_reserv._EntityID_)) , " = " , colr_reserv._Min_ColorID_ , ", " , colr_reserv._Max_ColorID_ );  
      } 
 
-     last_color_id = reserved_color_id_end - 1; 
+     last_color_id = color_id_allocator.get_end() - 1; 
+}
+
+/// @brief Reserve the pick ids of one entity
+/// @details  Called by the render kernel when its pick scheme / primitive count (or start id) no longer matches its reservation.
+///           The old range goes back to the free-list, the new one is taken from it (first fit) or from the top of the id space.
+void Gp_gui_scene::reserve_color_ids(const uint32_t entity_id, GeometryDescriptor& descriptor)
+{
+  const uint32_t required = descriptor.get_color_id_reserve_count();
+
+  std::unordered_map<uint32_t, unique_color_reservation>::iterator it = unique_colr_reservations.find(entity_id);
+  if(it != unique_colr_reservations.end())
+  {
+     const unique_color_reservation& current = it->second;
+     const uint32_t reserved = current._Max_ColorID_ - current._Min_ColorID_ + 1;
+     if(reserved == required && descriptor.get_color_id_reserve_start() == current._Min_ColorID_) return;
+
+     color_id_allocator.release(current._Min_ColorID_, reserved);
+     retire_color_reservation(entity_id);
+  }
+  drop_color_reservation_tombstones();
+
+  unique_color_reservation colr_reserv;
+  colr_reserv._EntityID_    = entity_id;
+  colr_reserv._Min_ColorID_ = color_id_allocator.allocate(required);
+  descriptor.set_color_id_reserve_start(colr_reserv._Min_ColorID_);
+  colr_reserv._Max_ColorID_ = descriptor.get_color_id_reserve_end();
+
+  unique_colr_reservations[entity_id] = colr_reserv;
+  color_reservation_table.insert(std::lower_bound(color_reservation_table.begin(), color_reservation_table.end(), colr_reserv._Min_ColorID_,
+                                                  [](const unique_color_reservation& reservation, const uint32_t id) { return reservation._Min_ColorID_ < id; }),
+                                 colr_reserv);
+
+  last_color_id = color_id_allocator.get_end() - 1;
+
+  DEBUG_PRINT("RESERVED IDS for Entity" , EntityKeyTable::GetInstance().str(get_entity_key(entity_id)) , " = " , colr_reserv._Min_ColorID_ , ", " , colr_reserv._Max_ColorID_ );
 }
 
 uint32_t Gp_gui_scene::get_actual_id(const uint32_t& color_id)
 {
-   std::unordered_map<uint32_t, unique_color_reservation>::iterator it       =  unique_colr_reservations.begin();
-   std::unordered_map<uint32_t, unique_color_reservation>::iterator iter_end =  unique_colr_reservations.end();
+   const unique_color_reservation* reservation = find_color_reservation(color_id);
+   return (reservation != nullptr) ? reservation->_EntityID_ : 0;
+}
 
-   for(it; it != iter_end; ++it)
-    {
-       if(color_id >= it->second._Min_ColorID_ && color_id <= it->second._Max_ColorID_)
-       {
-          return it->second._EntityID_;
-       }
-    }
+/// @brief Box selection
+/// @details  Distinct ids of the pick image inside the rectangle, resolved to entity / sub entity pairs
+/// @note Reads the image of the last pick pass, enable_region_of_interest(false) to select across the viewport
+std::vector<PickSelection> Gp_gui_scene::select_rectangle(const float& x0, const float& y0, const float& x1, const float& y1)
+{
+   const std::vector<uint32_t> ids = PublisherInstance->frame_buffer()->ids_in_rectangle(x0, y0, x1, y1, GL_PICK_ID_BASE, last_color_id + 1);
+   return resolve_color_ids(ids);
+}
+
+/// @brief Lasso selection
+/// @details  Distinct ids of the pick image inside the polygon, resolved to entity / sub entity pairs
+std::vector<PickSelection> Gp_gui_scene::select_lasso(const std::vector<glm::vec2>& lasso)
+{
+   const std::vector<uint32_t> ids = PublisherInstance->frame_buffer()->ids_in_lasso(lasso, GL_PICK_ID_BASE, last_color_id + 1);
+   return resolve_color_ids(ids);
+}
+
+/// @brief Occlusion aware pick under the cursor
+/// @details  Ids of the depth peeled layers of the last pick pass, the first entry is the visible one
+std::vector<PickSelection> Gp_gui_scene::select_through(const float& x, const float& y)
+{
+   std::vector<uint32_t> ids;
+   for(const framebuffer::LayerHit& hit : PublisherInstance->frame_buffer()->id_stack_at(x, y))
+     if(hit.id >= GL_PICK_ID_BASE && hit.id <= last_color_id) ids.push_back(hit.id);
+   return resolve_color_ids(ids);
+}
+
+/// @brief Occlusion aware box selection
+/// @details  Distinct ids of all the depth peeled layers inside the rectangle, nearest first
+std::vector<PickSelection> Gp_gui_scene::select_through_rectangle(const float& x0, const float& y0, const float& x1, const float& y1)
+{
+   std::vector<uint32_t> ids;
+   for(const framebuffer::LayerHit& hit : PublisherInstance->frame_buffer()->id_stack_in_rectangle(x0, y0, x1, y1))
+     if(hit.id >= GL_PICK_ID_BASE && hit.id <= last_color_id) ids.push_back(hit.id);
+   return resolve_color_ids(ids);
+}
+
+/// @brief World positions / normals of every pixel of a rectangle of the pick image (see framebuffer::surface_in_rectangle)
+/// @details Unprojected with the camera of the pass the image comes from, not the current one (asynchronous readback lags behind)
+std::vector<framebuffer::SurfaceSample> Gp_gui_scene::unproject_rectangle(const float& x0, const float& y0, const float& x1, const float& y1, uint32_t& width, uint32_t& height)
+{
+   framebuffer* frame_buffer = PublisherInstance->frame_buffer();
+   return frame_buffer->surface_in_rectangle(x0, y0, x1, y1, frame_buffer->image_inverse_view_projection(), width, height);
+}
+
+/// @brief inverse(projection * view), recomputed only when the scene matrices changed
+const glm::mat4& Gp_gui_scene::get_inverse_view_projection()
+{
+   const glm::mat4 view_projection = m_scene_state_obj.m_projection * m_scene_state_obj.m_view;
+   if(view_projection != m_view_projection)
+   {
+     m_view_projection = view_projection;
+     m_inverse_view_projection = glm::inverse(view_projection);
+   }
+   return m_inverse_view_projection;
+}
+
+/// @brief Sources of the CPU ray pick engine
+/// @details  Every entity with a descriptor, reported with the same entity id as the GPU pick (the kernel id)
+std::vector<RayPickEngine::Source> Gp_gui_scene::ray_pick_sources()
+{
+   std::vector<RayPickEngine::Source> sources;
+   sources.reserve(Entity_DataBase.size());
+   for(ecs::Entity& entity : Entity_DataBase)
+   {
+     OpenGL_3_3_RenderKernel& kernel = entity.get<OpenGL_3_3_RenderKernel>();
+     if(kernel.get_descriptor() != nullptr) sources.push_back(RayPickEngine::Source{kernel.get_kernel_id(), kernel.get_descriptor(), Transforms.get_world_matrix(kernel.get_kernel_id())});
+   }
+   return sources;
+}
+
+/// @brief Resolve color ids in order, consecutive ids of the same reservation reuse the previous lookup
+std::vector<PickSelection> Gp_gui_scene::resolve_color_ids(const std::vector<uint32_t>& ids) const
+{
+   std::vector<PickSelection> selection;
+   selection.reserve(ids.size());
+   const unique_color_reservation* reservation = nullptr;
+   for(const uint32_t color_id : ids)
+   {
+     if(reservation == nullptr || color_id < reservation->_Min_ColorID_ || color_id > reservation->_Max_ColorID_)
+       reservation = find_color_reservation(color_id);
+     if(reservation != nullptr)
+       selection.push_back(PickSelection{reservation->_EntityID_, color_id - reservation->_Min_ColorID_});
+   }
+   return selection;
+}
+
+/// @brief Find the reservation containing the color id
+/// @details  Binary search for the last interval starting at or before color_id in the sorted reservation table
+const unique_color_reservation* Gp_gui_scene::find_color_reservation(const uint32_t& color_id) const
+{
+   std::vector<unique_color_reservation>::const_iterator it =
+       std::upper_bound(color_reservation_table.begin(), color_reservation_table.end(), color_id,
+                        [](const uint32_t id, const unique_color_reservation& reservation) { return id < reservation._Min_ColorID_; });
 
-   return 0;
+   if(it == color_reservation_table.begin()) return nullptr;
+   --it;
+   return (color_id <= it->_Max_ColorID_) ? &(*it) : nullptr;
 }
 
 void Gp_gui_scene::set_system_state(const bool& state)
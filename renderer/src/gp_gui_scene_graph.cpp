@@ -0,0 +1,142 @@
+#include "gp_gui_scene_graph.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace gridpro_gui
+{
+    TransformComponent* SceneGraph::find(const uint32_t entity_id)
+    {
+        ecs::Entity* entity = m_entities.get(entity_id);
+        if(entity == nullptr || !entity->has<TransformComponent>()) return nullptr;
+        return &entity->get<TransformComponent>();
+    }
+
+    TransformComponent& SceneGraph::node(const uint32_t entity_id)
+    {
+        ecs::Entity* entity = m_entities.get(entity_id);
+        if(entity == nullptr) throw std::runtime_error("SceneGraph : entity " + std::to_string(entity_id) + " is not in the scene");
+        if(!entity->has<TransformComponent>()) entity->add<TransformComponent>();
+        return entity->get<TransformComponent>();
+    }
+
+    void SceneGraph::set_local_transform(const uint32_t entity_id, const glm::mat4& local)
+    {
+        node(entity_id).local = local;
+        mark_dirty(entity_id);
+    }
+
+    const glm::mat4& SceneGraph::get_local_transform(const uint32_t entity_id)
+    {
+        static const glm::mat4 identity(1.0f);
+        const TransformComponent* transform = find(entity_id);
+        return transform != nullptr ? transform->local : identity;
+    }
+
+    void SceneGraph::set_parent(const uint32_t entity_id, const uint32_t parent_id)
+    {
+        TransformComponent& child = node(entity_id);
+        if(child.parent == parent_id) return;
+
+        if(parent_id != TransformComponent::NO_PARENT)
+        {
+            /// The new parent must not be the entity itself or one of its descendants
+            node(parent_id);
+            for(uint32_t ancestor = parent_id; ancestor != TransformComponent::NO_PARENT; ancestor = find(ancestor)->parent)
+                if(ancestor == entity_id) throw std::runtime_error("SceneGraph : parenting " + std::to_string(entity_id) + " to " + std::to_string(parent_id) + " creates a cycle");
+        }
+
+        /// node() may have added a component to the parent, so the child is looked up again
+        TransformComponent& attached = *find(entity_id);
+        if(attached.parent != TransformComponent::NO_PARENT)
+        {
+            std::vector<uint32_t>& siblings = find(attached.parent)->children;
+            siblings.erase(std::find(siblings.begin(), siblings.end(), entity_id));
+        }
+
+        attached.parent = parent_id;
+        if(parent_id != TransformComponent::NO_PARENT) find(parent_id)->children.push_back(entity_id);
+        mark_dirty(entity_id);
+    }
+
+    const uint32_t SceneGraph::get_parent(const uint32_t entity_id)
+    {
+        const TransformComponent* transform = find(entity_id);
+        return transform != nullptr ? transform->parent : TransformComponent::NO_PARENT;
+    }
+
+    void SceneGraph::mark_dirty(const uint32_t entity_id)
+    {
+        m_stack.clear();
+        m_stack.push_back(entity_id);
+        bool root = true;
+        while(!m_stack.empty())
+        {
+            TransformComponent* transform = find(m_stack.back());
+            m_stack.pop_back();
+            /// A changed node always propagates, a dirty descendant already has a dirty subtree
+            if(transform == nullptr || (transform->world_dirty && !root)) continue;
+            root = false;
+
+            transform->world_dirty = true;
+            m_stack.insert(m_stack.end(), transform->children.begin(), transform->children.end());
+        }
+    }
+
+    const glm::mat4& SceneGraph::get_world_matrix(const uint32_t entity_id)
+    {
+        static const glm::mat4 identity(1.0f);
+        TransformComponent* transform = find(entity_id);
+        if(transform == nullptr) return identity;
+        if(!transform->world_dirty) return transform->world;
+
+        /// Walk up to the first clean ancestor (or the root), then resolve the chain top down
+        m_stack.clear();
+        for(uint32_t id = entity_id; id != TransformComponent::NO_PARENT; )
+        {
+            TransformComponent* current = find(id);
+            if(!current->world_dirty) break;
+            m_stack.push_back(id);
+            id = current->parent;
+        }
+
+        while(!m_stack.empty())
+        {
+            TransformComponent& current = *find(m_stack.back());
+            m_stack.pop_back();
+            current.world = (current.parent != TransformComponent::NO_PARENT) ? find(current.parent)->world * current.local : current.local;
+            current.world_dirty = false;
+            ++current.world_version;
+        }
+        return transform->world;
+    }
+
+    const uint32_t SceneGraph::get_world_version(const uint32_t entity_id)
+    {
+        TransformComponent* transform = find(entity_id);
+        if(transform == nullptr) return 0;
+        get_world_matrix(entity_id);
+        return transform->world_version;
+    }
+
+    void SceneGraph::remove(const uint32_t entity_id)
+    {
+        TransformComponent* transform = find(entity_id);
+        if(transform == nullptr) return;
+
+        if(transform->parent != TransformComponent::NO_PARENT)
+        {
+            std::vector<uint32_t>& siblings = find(transform->parent)->children;
+            siblings.erase(std::find(siblings.begin(), siblings.end(), entity_id));
+        }
+
+        const std::vector<uint32_t> children = transform->children;
+        for(const uint32_t child : children)
+        {
+            find(child)->parent = TransformComponent::NO_PARENT;
+            mark_dirty(child);
+        }
+        transform->children.clear();
+        transform->parent = TransformComponent::NO_PARENT;
+    }
+}
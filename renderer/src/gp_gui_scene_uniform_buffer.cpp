@@ -0,0 +1,50 @@
+#include "gp_gui_scene_uniform_buffer.h"
+#include "gp_gui_gl_state_cache.h"
+#include <cstring>
+
+namespace gridpro_gui
+{
+    void SceneUniformBuffer::update(const SceneState& scene_state)
+    {
+        SceneUniformData data;
+        data.projection     = scene_state.m_projection;
+        data.view           = scene_state.m_view;
+        data.model          = scene_state.m_model;
+        data.light_position = glm::vec4(scene_state.Position, 1.0f);
+        data.light_ambient  = glm::vec4(scene_state.Ambient,  0.0f);
+        data.light_diffuse  = glm::vec4(scene_state.Diffuse,  0.0f);
+        data.light_specular = glm::vec4(scene_state.Specular, 0.0f);
+
+        if(m_ubo == 0)
+        {
+            Renderer::GL_API()->glGenBuffers(1, &m_ubo);
+            Renderer::GL_API()->glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+            Renderer::GL_API()->glBufferData(GL_UNIFORM_BUFFER, sizeof(SceneUniformData), nullptr, GL_DYNAMIC_DRAW);
+            Renderer::GL_API()->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            m_uploaded = false;
+        }
+
+        if(!m_uploaded || std::memcmp(&data, &m_data, sizeof(SceneUniformData)) != 0)
+        {
+            Renderer::GL_API()->glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+            Renderer::GL_API()->glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(SceneUniformData), &data);
+            Renderer::GL_API()->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            m_data     = data;
+            m_uploaded = true;
+        }
+
+        /// The binding point is context state that Qt may reuse, the cache forgets it on GLStateCache::invalidate() every frame
+        GLStateCache::GetInstance().bind_uniform_buffer_base(GL_SCENE_UNIFORM_BLOCK_BINDING, m_ubo);
+    }
+
+    void SceneUniformBuffer::release()
+    {
+        if(m_ubo != 0)
+        {
+            Renderer::GL_API()->glDeleteBuffers(1, &m_ubo);
+            GLStateCache::GetInstance().on_uniform_buffer_deleted(m_ubo);
+        }
+        m_ubo      = 0;
+        m_uploaded = false;
+    }
+}
@@ -1,7 +1,9 @@
 #include "gp_gui_shader.h" 
+#include "gp_gui_gl_state_cache.h"
 
 #include "glm/gtc/type_ptr.hpp"
 #include "glm/gtc/matrix_transform.hpp"
+#include <cstring>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////// public implementations: ////////////////////////////////////////
@@ -41,7 +43,7 @@ Shader::Shader(const std::string& filePathVertexShader, const std::string& fileP
 		throw e;
 	}
 	
-	 Renderer::GL_API()->glUseProgram(m_program);
+	 GLStateCache::GetInstance().use_program(m_program);
 }
 
 __INLINE__
@@ -68,7 +70,7 @@ Shader::Shader(const char* VertexShaderSource , const char* FragmentShaderSource
 		throw e;
 	}
 	
-	 Renderer::GL_API()->glUseProgram(m_program);
+	 GLStateCache::GetInstance().use_program(m_program);
 }
 
 __INLINE__ 
@@ -80,6 +82,7 @@ Shader& Shader::operator=(Shader&& other) noexcept
         vs = other.vs;
         fs = other.fs;
         uniformLocations = std::move(other.uniformLocations);
+        hashedUniformLocations = std::move(other.hashedUniformLocations);
         vertexAttribLocations = std::move(other.vertexAttribLocations);
         m_vertexShader = std::move(other.m_vertexShader);
         m_fragmentShader = std::move(other.m_fragmentShader);
@@ -99,6 +102,7 @@ Shader::Shader(const Shader& other)
     vs = other.vs;
     fs = other.fs;
     uniformLocations = (other.uniformLocations);
+    hashedUniformLocations = (other.hashedUniformLocations);
     vertexAttribLocations = (other.vertexAttribLocations);
     m_vertexShader = (other.m_vertexShader);
     m_fragmentShader = (other.m_fragmentShader);
@@ -110,7 +114,7 @@ void Shader::bind()
 	try
 	{ 
      if(m_program)
-        Renderer::GL_API()->glUseProgram(m_program);
+        GLStateCache::GetInstance().use_program(m_program);
 	 else
 	   throw std::runtime_error("Unable to bind Shader");
 	}
@@ -126,7 +130,7 @@ void Shader::unbind()
 	try
 	{ 
      if(m_program != 0)
-        Renderer::GL_API()->glUseProgram(0);
+        GLStateCache::GetInstance().use_program(0);
 	else
 	  throw std::runtime_error("Unable to unbind Shader");
 	}
@@ -140,13 +144,14 @@ __INLINE__
 GLint Shader::GetUniformLocation(const std::string& uniform_name) const
 {
 try {
-	 if(uniformLocations.find(uniform_name) == uniformLocations.end())
-	    uniformLocations[uniform_name] = Renderer::GL_API()->glGetUniformLocation(this->m_program, uniform_name.c_str());
+	 auto it = uniformLocations.find(uniform_name);
+	 if(it == uniformLocations.end())
+	    it = uniformLocations.emplace(uniform_name, Renderer::GL_API()->glGetUniformLocation(this->m_program, uniform_name.c_str())).first;
 	    
-      if(uniformLocations[uniform_name] == -1)  
+      if(it->second == -1)  
 	     throw std::runtime_error("Failed to get uniform location for: " + uniform_name);
 	  
-	  return uniformLocations[uniform_name];	 
+	  return it->second;	 
     }
 catch(const std::exception& e) {
         // Handle the exception (print an error message, log, etc.)
@@ -158,6 +163,29 @@ catch(const std::exception& e) {
 	return -1;
 }
 
+__INLINE__
+GLint Shader::GetUniformLocation(const UniformName& uniform_name) const
+{
+	 auto it = hashedUniformLocations.find(uniform_name.hash);
+	 if(it == hashedUniformLocations.end())
+	 {
+	    const GLint location = Renderer::GL_API()->glGetUniformLocation(this->m_program, uniform_name.name);
+	    it = hashedUniformLocations.emplace(uniform_name.hash, HashedUniformLocation{uniform_name.name, location}).first;
+	    /// Missing (or optimised out) uniforms are reported once, glUniform* ignores location -1
+	    if(location == -1)
+	    {
+	       DEBUG_PRINT("Failed to get uniform location for: ", uniform_name.name, "\n");
+	    }
+	 }
+
+	  /// Colliding hash : the cache slot belongs to the first name, the other one is looked up every time
+	  /// (names are string literals, equal pointers are the common case and spare the strcmp)
+	  if(it->second.name != uniform_name.name && std::strcmp(it->second.name, uniform_name.name) != 0)
+	     return Renderer::GL_API()->glGetUniformLocation(this->m_program, uniform_name.name);
+
+	  return it->second.location;
+}
+
 __INLINE__
 GLint Shader::GetVertexAttribLocation(const std::string& attrib_name) const
 {
@@ -223,6 +251,84 @@ void Shader::SetMat4fv(const std::string& uniform_name, const glm::mat4& value)
       Renderer::GL_API()->glUniformMatrix4fv(GetUniformLocation(uniform_name), 1, GL_FALSE, glm::value_ptr(value));
 }
 
+__INLINE__ 
+void Shader::Set1i(const UniformName& uniform_name, const int& value)
+{
+       Renderer::GL_API()->glUniform1i(GetUniformLocation(uniform_name), value);
+}
+
+__INLINE__ 
+void Shader::Set1ui(const UniformName& uniform_name, const uint32_t& value)
+{
+       Renderer::GL_API()->glUniform1ui(GetUniformLocation(uniform_name), value);
+}
+
+__INLINE__ 
+void Shader::Set1f(const UniformName& uniform_name, const float& value)
+{
+       Renderer::GL_API()->glUniform1f(GetUniformLocation(uniform_name), value);
+}
+
+__INLINE__ 
+void Shader::SetVec3fv(const UniformName& uniform_name, const glm::vec3& value)
+{
+       Renderer::GL_API()->glUniform3fv(GetUniformLocation(uniform_name), 1, glm::value_ptr(value));
+}
+
+__INLINE__ 
+void Shader::SetVec4fv(const UniformName& uniform_name, const glm::vec4& value)
+{
+       Renderer::GL_API()->glUniform4fv(GetUniformLocation(uniform_name), 1, glm::value_ptr(value));
+}
+
+__INLINE__ 
+void Shader::SetMat4fv(const UniformName& uniform_name, const glm::mat4& value)
+{
+       Renderer::GL_API()->glUniformMatrix4fv(GetUniformLocation(uniform_name), 1, GL_FALSE, glm::value_ptr(value));
+}
+
+__INLINE__ 
+void Shader::Set(const UniformHandle<int>& handle, const int& value)
+{
+       Renderer::GL_API()->glUniform1i(handle.location, value);
+}
+
+__INLINE__ 
+void Shader::Set(const UniformHandle<float>& handle, const float& value)
+{
+       Renderer::GL_API()->glUniform1f(handle.location, value);
+}
+
+__INLINE__ 
+void Shader::Set(const UniformHandle<glm::vec2>& handle, const glm::vec2& value)
+{
+       Renderer::GL_API()->glUniform2fv(handle.location, 1, glm::value_ptr(value));
+}
+
+__INLINE__ 
+void Shader::Set(const UniformHandle<glm::vec3>& handle, const glm::vec3& value)
+{
+       Renderer::GL_API()->glUniform3fv(handle.location, 1, glm::value_ptr(value));
+}
+
+__INLINE__ 
+void Shader::Set(const UniformHandle<glm::vec4>& handle, const glm::vec4& value)
+{
+       Renderer::GL_API()->glUniform4fv(handle.location, 1, glm::value_ptr(value));
+}
+
+__INLINE__ 
+void Shader::Set(const UniformHandle<glm::mat3>& handle, const glm::mat3& value)
+{
+       Renderer::GL_API()->glUniformMatrix3fv(handle.location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+__INLINE__ 
+void Shader::Set(const UniformHandle<glm::mat4>& handle, const glm::mat4& value)
+{
+       Renderer::GL_API()->glUniformMatrix4fv(handle.location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
 __INLINE__ 
 int Shader::program()
 {
@@ -243,6 +349,7 @@ void Shader::delete_shader()
 	 if (m_program != 0)
 	 {
  		 Renderer::GL_API()->glDeleteProgram(m_program);
+		 GLStateCache::GetInstance().on_program_deleted(m_program);
 	 }
 	 else
 	 {
@@ -361,6 +468,7 @@ bool Shader::createShader(const std::string& vertexShader, const std::string& fr
 			<< "\n";
 		std::cout << infoLog << std::endl;
 		 Renderer::GL_API()->glDeleteProgram(m_program);
+		 GLStateCache::GetInstance().on_program_deleted(m_program);
 		return false;
 	}
 	 Renderer::GL_API()->glValidateProgram(m_program);
@@ -0,0 +1,182 @@
+#include "gp_gui_streaming_uploader.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace gridpro_gui
+{
+    namespace
+    {
+        typedef void (QOPENGLF_APIENTRYP BufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+        /// @brief glBufferStorage is GL 4.4 and not part of the 4.3 function table
+        BufferStorageProc get_buffer_storage_proc()
+        {
+            QOpenGLContext* context = QOpenGLContext::currentContext();
+            if(context == nullptr) return nullptr;
+            return reinterpret_cast<BufferStorageProc>(context->getProcAddress("glBufferStorage"));
+        }
+    }
+
+    StreamingUploader::StreamingUploader()
+    : m_ring_buffer(0), m_mapped_ring(nullptr), m_segment_size(GL_STREAMING_SEGMENT_SIZE), m_segment_head(0), m_segment(0),
+      m_persistent(false), m_init_flag(false)
+    {
+        m_fences.fill(nullptr);
+    }
+
+    void StreamingUploader::init()
+    {
+        if(m_init_flag) return;
+
+        const GLsizeiptr ring_size = m_segment_size * NUM_SEGMENTS;
+        Renderer::GL_API()->glGenBuffers(1, &m_ring_buffer);
+        Renderer::GL_API()->glBindBuffer(GL_COPY_READ_BUFFER, m_ring_buffer);
+
+        BufferStorageProc buffer_storage = get_buffer_storage_proc();
+        if(buffer_storage != nullptr)
+        {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            buffer_storage(GL_COPY_READ_BUFFER, ring_size, nullptr, flags);
+            m_mapped_ring = static_cast<GLubyte*>(Renderer::GL_API()->glMapBufferRange(GL_COPY_READ_BUFFER, 0, ring_size, flags));
+            m_persistent  = (m_mapped_ring != nullptr);
+        }
+
+        if(!m_persistent)
+        {
+            Renderer::GL_API()->glBufferData(GL_COPY_READ_BUFFER, ring_size, nullptr, GL_STREAM_DRAW);
+        }
+
+        Renderer::GL_API()->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        DEBUG_PRINT("Streaming uploader ring = ", ring_size, " bytes, persistent = ", m_persistent);
+        m_init_flag = true;
+    }
+
+    void StreamingUploader::upload(const GLuint dst_buffer, const GLintptr dst_offset, const GLsizeiptr size, const void* data)
+    {
+        if(size <= 0 || data == nullptr) return;
+        init();
+
+        const GLubyte* src = static_cast<const GLubyte*>(data);
+        GLsizeiptr copied  = 0;
+
+        Renderer::GL_API()->glBindBuffer(GL_COPY_WRITE_BUFFER, dst_buffer);
+
+        /// Uploads larger than the free part of a segment are split across segments
+        while(copied < size)
+        {
+            if(m_segment_head == m_segment_size) advance_segment();
+            Renderer::GL_API()->glBindBuffer(GL_COPY_READ_BUFFER, m_ring_buffer);
+
+            const GLsizeiptr chunk       = std::min(size - copied, m_segment_size - m_segment_head);
+            const GLintptr   ring_offset = m_segment * m_segment_size + m_segment_head;
+
+            GLubyte* staging = map_range(ring_offset, chunk);
+            if(staging == nullptr) throw std::runtime_error("StreamingUploader : failed to map the staging ring");
+            std::memcpy(staging, src + copied, chunk);
+            unmap_range();
+
+            Renderer::GL_API()->glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, ring_offset, dst_offset + copied, chunk);
+
+            m_segment_head += chunk;
+            copied         += chunk;
+        }
+
+        Renderer::GL_API()->glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        Renderer::GL_API()->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        m_fence_statistics.record_bytes(size);
+    }
+
+    void StreamingUploader::end_frame()
+    {
+        if(!m_init_flag || m_segment_head == 0) return;
+        advance_segment();
+    }
+
+    /// @brief Fence the current segment and wait until the GPU has released the next one
+    void StreamingUploader::advance_segment()
+    {
+        if(m_persistent)
+        {
+            if(m_fences[m_segment] != nullptr) Renderer::GL_API()->glDeleteSync(m_fences[m_segment]);
+            m_fences[m_segment] = Renderer::GL_API()->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        m_segment      = (m_segment + 1) % NUM_SEGMENTS;
+        m_segment_head = 0;
+
+        if(m_persistent)
+        {
+            wait_for_segment(m_segment);
+        }
+        else if(m_segment == 0)
+        {
+            /// Orphan the ring when it wraps so the driver hands out fresh storage
+            Renderer::GL_API()->glBindBuffer(GL_COPY_READ_BUFFER, m_ring_buffer);
+            Renderer::GL_API()->glBufferData(GL_COPY_READ_BUFFER, m_segment_size * NUM_SEGMENTS, nullptr, GL_STREAM_DRAW);
+            Renderer::GL_API()->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            m_fence_statistics.record_orphan();
+        }
+    }
+
+    void StreamingUploader::wait_for_segment(const uint32_t segment)
+    {
+        GLsync fence = m_fences[segment];
+        if(fence == nullptr) return;
+
+        const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+        GLenum result = Renderer::GL_API()->glClientWaitSync(fence, 0, 0);
+        const bool stalled = (result == GL_TIMEOUT_EXPIRED);
+        while(result == GL_TIMEOUT_EXPIRED)
+            result = Renderer::GL_API()->glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_STREAMING_FENCE_TIMEOUT_NS);
+
+        if(result == GL_WAIT_FAILED) std::cerr << "StreamingUploader : glClientWaitSync failed\n";
+
+        const std::chrono::nanoseconds waited = std::chrono::high_resolution_clock::now() - start;
+        m_fence_statistics.record_wait(waited.count() / 1.0e6, stalled);
+
+        Renderer::GL_API()->glDeleteSync(fence);
+        m_fences[segment] = nullptr;
+    }
+
+    GLubyte* StreamingUploader::map_range(const GLintptr ring_offset, const GLsizeiptr size)
+    {
+        if(m_persistent) return m_mapped_ring + ring_offset;
+
+        /// The range was orphaned or never used since the last wrap, so it can be written unsynchronized
+        const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        return static_cast<GLubyte*>(Renderer::GL_API()->glMapBufferRange(GL_COPY_READ_BUFFER, ring_offset, size, access));
+    }
+
+    void StreamingUploader::unmap_range()
+    {
+        if(!m_persistent) Renderer::GL_API()->glUnmapBuffer(GL_COPY_READ_BUFFER);
+    }
+
+    void StreamingUploader::release()
+    {
+        if(!m_init_flag) return;
+
+        for(GLsync& fence : m_fences)
+        {
+            if(fence != nullptr) Renderer::GL_API()->glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        if(m_persistent)
+        {
+            Renderer::GL_API()->glBindBuffer(GL_COPY_READ_BUFFER, m_ring_buffer);
+            Renderer::GL_API()->glUnmapBuffer(GL_COPY_READ_BUFFER);
+            Renderer::GL_API()->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        }
+
+        Renderer::GL_API()->glDeleteBuffers(1, &m_ring_buffer);
+        m_ring_buffer  = 0;
+        m_mapped_ring  = nullptr;
+        m_segment      = 0;
+        m_segment_head = 0;
+        m_persistent   = false;
+        m_init_flag    = false;
+    }
+}
@@ -1,10 +1,52 @@
 #include "gp_gui_vertex_array_object.h"
 #include "gp_gui_geometry_descriptor.h"
+#include "gp_gui_streaming_uploader.h"
+#include "gp_gui_gl_state_cache.h"
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 
 namespace gridpro_gui
 {
+   namespace
+   {
+       /// @brief Encode a float in [0, 1] as 16 bit unorm
+       inline uint16_t encode_unorm16(const float value)
+       {
+           return static_cast<uint16_t>(std::lround(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f));
+       }
 
-   VertexArrayObject::VertexArrayObject() : m_vao(0), m_vbo(0), m_ibo(0), m_vbo_curr_size(0), m_ibo_curr_size(0)
+       /// @brief Encode a float in [-1, 1] as 16 bit snorm
+       inline int16_t encode_snorm16(const float value)
+       {
+           return static_cast<int16_t>(std::lround(std::min(std::max(value, -1.0f), 1.0f) * 32767.0f));
+       }
+
+       /// @brief Octahedral normal encoding (project on the octahedron, fold the lower hemisphere)
+       /// @details GLSL decode : vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+       /// @details               if(n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy); n = normalize(n);
+       inline void encode_octahedral(const float* normal, int16_t* encoded)
+       {
+           const float l1 = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+           float x = l1 > 0.0f ? normal[0] / l1 : 0.0f;
+           float y = l1 > 0.0f ? normal[1] / l1 : 0.0f;
+           if(normal[2] < 0.0f)
+           {
+               const float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+               const float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+               x = fx; y = fy;
+           }
+           encoded[0] = encode_snorm16(x);
+           encoded[1] = encode_snorm16(y);
+       }
+   }
+
+   VertexArrayObject::VertexArrayObject() : m_vao(0), m_vbo(0), m_ibo(0), m_vbo_curr_size(0), m_ibo_curr_size(0), m_geometry_descriptor(nullptr),
+                                            m_interleaved(false), m_stride(0), cComponents(3), m_vbo_data_size(0),
+        m_quantized(false), m_streamed(false), m_position_bytes(3 * sizeof(float)), m_normal_bytes(3 * sizeof(float)),
+        m_position_offset{{0.0f, 0.0f, 0.0f}}, m_position_scale{{1.0f, 1.0f, 1.0f}}, m_index_type(GL_UNSIGNED_INT), m_staged(false),
+        m_vbo_offset(0), m_ibo_offset(0), m_ibo_bytes(0), m_instance_vbo(0), m_instance_bytes(0), m_num_instances(0), m_instance_colors(false)
     {
          PositionData = &DummyData1;
          NormalData   = &DummyData1;
@@ -16,7 +58,11 @@ namespace gridpro_gui
     }
 
     VertexArrayObject::VertexArrayObject(std::vector<float>* position_data , std::vector<float>* normal_data , std::vector<GLubyte>* color_data) :
-        m_vao(0), m_vbo(0), m_ibo(0), m_vbo_curr_size(0), m_ibo_curr_size(0)
+        m_vao(0), m_vbo(0), m_ibo(0), m_vbo_curr_size(0), m_ibo_curr_size(0), m_geometry_descriptor(nullptr),
+        m_interleaved(false), m_stride(0), cComponents(3), m_vbo_data_size(0),
+        m_quantized(false), m_streamed(false), m_position_bytes(3 * sizeof(float)), m_normal_bytes(3 * sizeof(float)),
+        m_position_offset{{0.0f, 0.0f, 0.0f}}, m_position_scale{{1.0f, 1.0f, 1.0f}}, m_index_type(GL_UNSIGNED_INT), m_staged(false),
+        m_vbo_offset(0), m_ibo_offset(0), m_ibo_bytes(0), m_instance_vbo(0), m_instance_bytes(0), m_num_instances(0), m_instance_colors(false)
     { 
          PositionData = &DummyData1;
          NormalData   = &DummyData1;
@@ -42,12 +88,13 @@ namespace gridpro_gui
 
 
     VertexArrayObject::VertexArrayObject(GeometryDescriptor* geometry_descriptor) :
-        m_geometry_descriptor(geometry_descriptor) , m_vao(0), m_vbo(0), m_ibo(0), m_vbo_curr_size(0), m_ibo_curr_size(0)
+        m_geometry_descriptor(geometry_descriptor) , m_vao(0), m_vbo(0), m_ibo(0), m_vbo_curr_size(0), m_ibo_curr_size(0),
+        m_interleaved(false), m_stride(0), cComponents(3), m_vbo_data_size(0),
+        m_quantized(false), m_streamed(false), m_position_bytes(3 * sizeof(float)), m_normal_bytes(3 * sizeof(float)),
+        m_position_offset{{0.0f, 0.0f, 0.0f}}, m_position_scale{{1.0f, 1.0f, 1.0f}}, m_index_type(GL_UNSIGNED_INT), m_staged(false),
+        m_vbo_offset(0), m_ibo_offset(0), m_ibo_bytes(0), m_instance_vbo(0), m_instance_bytes(0), m_num_instances(0), m_instance_colors(false)
     {
-        PositionData = (*m_geometry_descriptor)->get_position_weak_ptr().lock().get();
-        NormalData   = (*m_geometry_descriptor)->get_normals_weak_ptr().lock().get();
-        ColorData    = (*m_geometry_descriptor)->get_colors_weak_ptr().lock().get();
-        IndexData    = (*m_geometry_descriptor)->get_indices_weak_ptr().lock().get();
+        refresh_descriptor_state();
         
         if(PositionData->size() == 0) 
         {
@@ -66,9 +113,161 @@ namespace gridpro_gui
 
     VertexArrayObject::~VertexArrayObject()
     {
+        /// A staged object that was never uploaded owns no GL names (and may die off the GL thread)
+        if(m_vao == 0 && m_vbo == 0 && m_ibo == 0) return;
+
         Renderer::GL_API()->glDeleteVertexArrays(1, &m_vao);
+        GLStateCache::GetInstance().on_vertex_array_deleted(m_vao);
         delete_vbo();
         delete_ibo();
+        if(m_instance_vbo != 0) Renderer::GL_API()->glDeleteBuffers(1, &m_instance_vbo);
+    }
+
+    void VertexArrayObject::stage(GeometryDescriptor* geometry_descriptor)
+    {
+        m_geometry_descriptor = geometry_descriptor;
+        refresh_descriptor_state();
+
+        if(PositionData == nullptr || PositionData->size() == 0)
+        {
+            std::string err = m_geometry_descriptor->get_current_primitive_set_name() + " Position Data is empty\n";
+            throw std::runtime_error(err);
+        }
+
+        calculate_offsets();
+        pack_vertex_data(m_staged_vertices);
+        pack_index_data(m_staged_indices);
+        m_staged = true;
+    }
+
+    void VertexArrayObject::upload_staged()
+    {
+        if(!m_staged) return;
+
+        Renderer::GL_API()->glGenVertexArrays(1, &m_vao);
+        GLStateCache::GetInstance().bind_vertex_array(m_vao);
+        allocate_vertex_storage();
+        buffer_sub_data(GL_ARRAY_BUFFER, m_vbo, 0, m_staged_vertices.size(), m_staged_vertices.data());
+
+        set_vertex_attribute_pointers();
+        m_uploaded_layout = current_layout();
+        Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        if(m_staged_indices.size())
+        {
+            m_index_type = select_index_type();
+            allocate_index_storage(m_staged_indices.size());
+            buffer_sub_data(GL_ELEMENT_ARRAY_BUFFER, m_ibo, 0, m_staged_indices.size(), m_staged_indices.data());
+            m_ibo_curr_size = IndexData->size();
+        }
+        unbind();
+
+        std::vector<GLubyte>().swap(m_staged_vertices);
+        std::vector<GLubyte>().swap(m_staged_indices);
+        m_staged = false;
+    }
+
+    namespace
+    {
+        /// @brief Copy the blobs into the ranges of one batch allocation (one page) with a single mapped write
+        void write_batch_ranges(const std::vector<GpuBufferArena::Allocation>& ranges, const std::vector<const std::vector<GLubyte>*>& blobs)
+        {
+            if(ranges.empty()) return;
+
+            const GLintptr   begin = ranges.front().offset;
+            const GLsizeiptr span  = ranges.back().offset + ranges.back().size - begin;
+
+            /// GL_COPY_WRITE_BUFFER keeps the element array binding of the bound VAO untouched
+            Renderer::GL_API()->glBindBuffer(GL_COPY_WRITE_BUFFER, ranges.front().buffer);
+            GLubyte* mapped = static_cast<GLubyte*>(Renderer::GL_API()->glMapBufferRange(GL_COPY_WRITE_BUFFER, begin, span, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT));
+            if(mapped != nullptr)
+            {
+                for(size_t i = 0; i < ranges.size(); ++i)
+                    std::memcpy(mapped + (ranges[i].offset - begin), blobs[i]->data(), blobs[i]->size());
+                Renderer::GL_API()->glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            }
+            else
+            {
+                for(size_t i = 0; i < ranges.size(); ++i)
+                    Renderer::GL_API()->glBufferSubData(GL_COPY_WRITE_BUFFER, ranges[i].offset, ranges[i].size, blobs[i]->data());
+            }
+            Renderer::GL_API()->glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+    }
+
+    void VertexArrayObject::upload_staged_batch(const std::vector<VertexArrayObject*>& objects)
+    {
+        std::vector<VertexArrayObject*> batched;
+        std::vector<GLsizeiptr> vertex_sizes, vertex_alignments, index_sizes, index_alignments;
+        std::vector<const std::vector<GLubyte>*> vertex_blobs, index_blobs;
+
+        for(VertexArrayObject* object : objects)
+        {
+            if(object == nullptr || !object->is_staged()) continue;
+
+            /// Private buffers (streamed sets, arena disabled) keep the per object path
+            if(!object->use_buffer_arena() || object->m_staged_vertices.empty())
+            {
+                object->upload_staged();
+                continue;
+            }
+
+            batched.push_back(object);
+            vertex_sizes.push_back(object->m_staged_vertices.size());
+            vertex_alignments.push_back(object->vertex_alignment());
+            vertex_blobs.push_back(&object->m_staged_vertices);
+            if(object->m_staged_indices.size())
+            {
+                index_sizes.push_back(object->m_staged_indices.size());
+                index_alignments.push_back(sizeof(uint32_t));
+                index_blobs.push_back(&object->m_staged_indices);
+            }
+        }
+        if(batched.empty()) return;
+
+        const std::vector<GpuBufferArena::Allocation> vertex_ranges = GpuBufferArena::GetInstance().allocate_batch(GpuBufferArena::VERTEX_POOL, vertex_sizes, vertex_alignments);
+        const std::vector<GpuBufferArena::Allocation> index_ranges  = GpuBufferArena::GetInstance().allocate_batch(GpuBufferArena::INDEX_POOL, index_sizes, index_alignments);
+        write_batch_ranges(vertex_ranges, vertex_blobs);
+        write_batch_ranges(index_ranges, index_blobs);
+
+        size_t index_range = 0;
+        for(size_t i = 0; i < batched.size(); ++i)
+        {
+            const GpuBufferArena::Allocation no_indices;
+            const bool indexed = batched[i]->m_staged_indices.size() != 0;
+            batched[i]->adopt_staged_storage(vertex_ranges[i], indexed ? index_ranges[index_range++] : no_indices);
+        }
+    }
+
+    void VertexArrayObject::adopt_staged_storage(const GpuBufferArena::Allocation& vertex_range, const GpuBufferArena::Allocation& index_range)
+    {
+        Renderer::GL_API()->glGenVertexArrays(1, &m_vao);
+        GLStateCache::GetInstance().bind_vertex_array(m_vao);
+
+        m_vbo_allocation = vertex_range;
+        m_vbo            = vertex_range.buffer;
+        m_vbo_offset     = vertex_range.offset;
+        m_vbo_curr_size  = m_vbo_data_size;
+        Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        set_vertex_attribute_pointers();
+        m_uploaded_layout = current_layout();
+        Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        if(index_range.is_valid())
+        {
+            m_index_type     = select_index_type();
+            m_ibo_allocation = index_range;
+            m_ibo            = index_range.buffer;
+            m_ibo_offset     = index_range.offset;
+            m_ibo_bytes      = index_range.size;
+            m_ibo_curr_size  = IndexData->size();
+            Renderer::GL_API()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+        }
+        unbind();
+
+        std::vector<GLubyte>().swap(m_staged_vertices);
+        std::vector<GLubyte>().swap(m_staged_indices);
+        m_staged = false;
     }
 
     void VertexArrayObject::set_vertex_attribute(std::vector<float>* position_data = nullptr, std::vector<float>* normal_data = nullptr, std::vector<GLubyte>* color_data = nullptr)
@@ -114,20 +313,94 @@ namespace gridpro_gui
     } 
 
 
+    /// @brief Reallocate the instance buffer only when its size changes, the transforms and colors are rewritten in place otherwise
+    void VertexArrayObject::set_instance_attributes(const std::vector<float>& transforms, const std::vector<GLubyte>& colors)
+    {
+        const GLsizei instances = static_cast<GLsizei>(transforms.size() / 16);
+        if(instances == 0 || m_vao == 0)
+        {
+            delete_instance_buffer();
+            return;
+        }
+
+        const bool       instance_colors = colors.size() == static_cast<size_t>(instances) * 4;
+        const GLsizeiptr transform_bytes = static_cast<GLsizeiptr>(instances) * 16 * sizeof(float);
+        const GLsizeiptr instance_bytes  = transform_bytes + (instance_colors ? static_cast<GLsizeiptr>(colors.size()) : 0);
+
+        GLStateCache::GetInstance().bind_vertex_array(m_vao);
+        if(m_instance_vbo == 0) Renderer::GL_API()->glGenBuffers(1, &m_instance_vbo);
+        Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_instance_vbo);
+        if(instance_bytes != m_instance_bytes)
+        {
+            Renderer::GL_API()->glBufferData(GL_ARRAY_BUFFER, instance_bytes, nullptr, GL_DYNAMIC_DRAW);
+            m_instance_bytes = instance_bytes;
+        }
+        Renderer::GL_API()->glBufferSubData(GL_ARRAY_BUFFER, 0, transform_bytes, transforms.data());
+        if(instance_colors) Renderer::GL_API()->glBufferSubData(GL_ARRAY_BUFFER, transform_bytes, colors.size(), colors.data());
+
+        m_num_instances   = instances;
+        m_instance_colors = instance_colors;
+        set_instance_attribute_pointers();
+
+        Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+        unbind();
+    }
+
+    void VertexArrayObject::set_instance_attribute_pointers()
+    {
+        /// A mat4 attribute takes four consecutive locations, one vec4 column each
+        for(GLuint column = 0; column < 4; ++column)
+        {
+            const GLuint location = GL_INSTANCE_TRANSFORM_LOCATION + column;
+            Renderer::GL_API()->glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(float), (void*)(uintptr_t)(column * 4 * sizeof(float)));
+            Renderer::GL_API()->glVertexAttribDivisor(location, 1);
+            Renderer::GL_API()->glEnableVertexAttribArray(location);
+        }
+
+        if(m_instance_colors)
+        {
+            Renderer::GL_API()->glVertexAttribPointer(GL_INSTANCE_COLOR_LOCATION, 4, GL_UNSIGNED_BYTE, GL_TRUE, 4 * sizeof(GLubyte), (void*)(uintptr_t)(m_num_instances * 16 * sizeof(float)));
+            Renderer::GL_API()->glVertexAttribDivisor(GL_INSTANCE_COLOR_LOCATION, 1);
+            Renderer::GL_API()->glEnableVertexAttribArray(GL_INSTANCE_COLOR_LOCATION);
+        }
+        else
+        {
+            Renderer::GL_API()->glDisableVertexAttribArray(GL_INSTANCE_COLOR_LOCATION);
+        }
+    }
+
+    void VertexArrayObject::delete_instance_buffer()
+    {
+        if(m_instance_vbo == 0) return;
+
+        if(m_vao != 0)
+        {
+            GLStateCache::GetInstance().bind_vertex_array(m_vao);
+            for(GLuint location = GL_INSTANCE_TRANSFORM_LOCATION; location <= GL_INSTANCE_COLOR_LOCATION; ++location)
+                Renderer::GL_API()->glDisableVertexAttribArray(location);
+            unbind();
+        }
+        Renderer::GL_API()->glDeleteBuffers(1, &m_instance_vbo);
+        m_instance_vbo    = 0;
+        m_instance_bytes  = 0;
+        m_num_instances   = 0;
+        m_instance_colors = false;
+    }
+
     void VertexArrayObject::bind()
     {
-        if(Renderer::GL_API()->glIsVertexArray(m_vao) != GL_TRUE) 
+        if(m_vao == 0) 
         { 
             DEBUG_PRINT("VAO is not created\n");
             return;
         }   
         else
         {
-            Renderer::GL_API()->glBindVertexArray(m_vao);
+            GLStateCache::GetInstance().bind_vertex_array(m_vao);
             DEBUG_PRINT("VAO is bound\n");
         }
         
-        if(Renderer::GL_API()->glIsBuffer(m_ibo) == GL_TRUE)
+        if(m_ibo != 0)
         {
             Renderer::GL_API()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);       
         }
@@ -135,100 +408,473 @@ namespace gridpro_gui
 
     void VertexArrayObject::unbind()
     {
-        Renderer::GL_API()->glBindVertexArray(0);
+        GLStateCache::GetInstance().bind_vertex_array(0);
         Renderer::GL_API()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); 
     }
+
+    void VertexArrayObject::refresh_descriptor_state()
+    {
+        if(m_geometry_descriptor == nullptr) return;
+
+        PositionData = (*m_geometry_descriptor)->get_position_weak_ptr().lock().get();
+        NormalData   = (*m_geometry_descriptor)->get_normals_weak_ptr().lock().get();
+        ColorData    = (*m_geometry_descriptor)->get_colors_weak_ptr().lock().get();
+        IndexData    = (*m_geometry_descriptor)->get_indices_weak_ptr().lock().get();
+
+        m_interleaved = (*m_geometry_descriptor)->is_interleaved();
+        m_quantized   = (*m_geometry_descriptor)->is_quantized();
+        m_streamed    = (*m_geometry_descriptor)->is_streamed();
+        cComponents   = ((*m_geometry_descriptor)->get_color_format() == GeometryDescriptor::PrimitiveSetInstance::RGBA) ? 4 : 3;
+    }
     
     void VertexArrayObject::calculate_offsets()
     {
-        vSize = 0;
-        nSize = 0;
-        cSize = 0;
+        const uint32_t num_vertices = PositionData ? PositionData->size() / 3 : 0;
+        const uint32_t num_normals  = NormalData   ? NormalData->size()   / 3 : 0;
 
-        if (PositionData)
-            vSize = PositionData->size() * sizeof(float);
+        m_position_bytes = m_quantized ? 4 * sizeof(uint16_t) : 3 * sizeof(float);
+        m_normal_bytes   = m_quantized ? 2 * sizeof(int16_t)  : 3 * sizeof(float);
 
-        if (NormalData)
-            nSize = NormalData->size()   * sizeof(float);
+        vSize = num_vertices * m_position_bytes;
+        nSize = num_normals  * m_normal_bytes;
+        cSize = 0;
 
         if (ColorData)
             cSize = ColorData->size()    * sizeof(GLubyte);
 
-        vOffset = 0;
-        nOffset = vSize;
-        cOffset = vSize + nSize;
+        calculate_dequantization();
+
+        if (!m_interleaved)
+        {
+            vOffset  = 0;
+            nOffset  = vSize;
+            cOffset  = vSize + nSize;
+            m_stride = 0;
+            m_vbo_data_size = vSize + nSize + cSize;
+            return;
+        }
+
+        /// Normals and colors are interleaved only when there is exactly one per vertex
+        if (num_normals != num_vertices)                      nSize = 0;
+        if (cSize != num_vertices * cComponents * sizeof(GLubyte)) cSize = 0;
+
+        /// Color is padded to 4 bytes so that every vertex starts 4 byte aligned
+        vOffset  = 0;
+        nOffset  = m_position_bytes;
+        cOffset  = nOffset + (nSize ? m_normal_bytes : 0);
+        m_stride = cOffset + (cSize ? 4 * sizeof(GLubyte) : 0);
+        m_vbo_data_size = num_vertices * m_stride;
     }
 
-    void VertexArrayObject::create_vbo()
-    {   
-    
-        calculate_offsets();
-        /// @brief Allocate the vertex buffer object only if the vertex data size has changed
-        /// @note  This is to avoid the reallocation of the VBO for every frame
-        if(m_vbo_curr_size != vSize + nSize + cSize)
-        { 
-           delete_vao();
-           delete_vbo();
-           Renderer::GL_API()->glGenVertexArrays(1, &m_vao);
-           Renderer::GL_API()->glGenBuffers(1, &m_vbo);
-           Renderer::GL_API()->glBindVertexArray(m_vao);
-           Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-           Renderer::GL_API()->glBufferData(GL_ARRAY_BUFFER, vSize + nSize + cSize, nullptr, GL_STATIC_DRAW);
-           m_vbo_curr_size = vSize + nSize + cSize;
+    void VertexArrayObject::calculate_dequantization()
+    {
+        m_position_offset = {{0.0f, 0.0f, 0.0f}};
+        m_position_scale  = {{1.0f, 1.0f, 1.0f}};
+
+        if (!m_quantized || PositionData == nullptr || PositionData->size() < 3)
+            return;
+
+        std::array<float, 3> min_pos, max_pos;
+        min_pos.fill( std::numeric_limits<float>::max());
+        max_pos.fill(-std::numeric_limits<float>::max());
+
+        const std::vector<float>& pos = *PositionData;
+        for (size_t i = 0; i + 2 < pos.size(); i += 3)
+        {
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                min_pos[axis] = std::min(min_pos[axis], pos[i + axis]);
+                max_pos[axis] = std::max(max_pos[axis], pos[i + axis]);
+            }
+        }
+
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            m_position_offset[axis] = min_pos[axis];
+            m_position_scale[axis]  = max_pos[axis] - min_pos[axis];
+        }
+    }
+
+    void VertexArrayObject::write_position(const size_t i, GLubyte* dst) const
+    {
+        const float* position = PositionData->data() + i * 3;
+        if (!m_quantized)
+        {
+            std::memcpy(dst, position, 3 * sizeof(float));
+            return;
+        }
+
+        uint16_t encoded[4] = {0, 0, 0, 0};
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const float extent = m_position_scale[axis];
+            encoded[axis] = extent > 0.0f ? encode_unorm16((position[axis] - m_position_offset[axis]) / extent) : 0;
+        }
+        std::memcpy(dst, encoded, sizeof(encoded));
+    }
+
+    void VertexArrayObject::write_normal(const size_t i, GLubyte* dst) const
+    {
+        const float* normal = NormalData->data() + i * 3;
+        if (!m_quantized)
+        {
+            std::memcpy(dst, normal, 3 * sizeof(float));
+            return;
+        }
+
+        int16_t encoded[2];
+        encode_octahedral(normal, encoded);
+        std::memcpy(dst, encoded, sizeof(encoded));
+    }
+
+    void VertexArrayObject::pack_interleaved_vertex_range(const size_t first, const size_t last, std::vector<GLubyte>& packed_data) const
+    {
+        packed_data.assign((last - first) * m_stride, 0);
+
+        const GLubyte* colors = cSize ? ColorData->data() : nullptr;
+        GLubyte*       vertex = packed_data.data();
+
+        for (size_t i = first; i < last; ++i, vertex += m_stride)
+        {
+            write_position(i, vertex + vOffset);
+            if (nSize)
+                write_normal(i, vertex + nOffset);
+            if (colors)
+                std::memcpy(vertex + cOffset, colors + i * cComponents, cComponents * sizeof(GLubyte));
+        }
+    }
+
+    void VertexArrayObject::pack_vertex_data(std::vector<GLubyte>& vertex_data) const
+    {
+        const size_t num_vertices = vSize / m_position_bytes;
+        if (m_interleaved)
+        {
+            pack_interleaved_vertex_range(0, num_vertices, vertex_data);
+            return;
+        }
+
+        vertex_data.assign(m_vbo_data_size, 0);
+        for (size_t i = 0; i < num_vertices; ++i)
+            write_position(i, vertex_data.data() + vOffset + i * m_position_bytes);
+        for (size_t i = 0; i < nSize / m_normal_bytes; ++i)
+            write_normal(i, vertex_data.data() + nOffset + i * m_normal_bytes);
+        if (cSize)
+            std::memcpy(vertex_data.data() + cOffset, ColorData->data(), cSize);
+    }
+
+    void VertexArrayObject::pack_index_data(std::vector<GLubyte>& index_data) const
+    {
+        index_data.clear();
+        if (IndexData == nullptr || IndexData->size() == 0) return;
+
+        if (select_index_type() == GL_UNSIGNED_SHORT)
+        {
+            index_data.resize(IndexData->size() * sizeof(uint16_t));
+            uint16_t* dst = reinterpret_cast<uint16_t*>(index_data.data());
+            for (size_t i = 0; i < IndexData->size(); ++i)
+                dst[i] = static_cast<uint16_t>((*IndexData)[i]);
         }
         else
         {
-           Renderer::GL_API()->glBindVertexArray(m_vao);
-           Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+            index_data.resize(IndexData->size() * sizeof(uint32_t));
+            std::memcpy(index_data.data(), IndexData->data(), index_data.size());
         }
+    }
 
-    
-        uint32_t it = 0;
+    void VertexArrayObject::upload_planar_range(const uint32_t attribute, const size_t first, const size_t last)
+    {
+        if (first >= last) return;
 
-        // Copy data to VBO
-        if (vSize != 0)
-            Renderer::GL_API()->glBufferSubData(GL_ARRAY_BUFFER, vOffset, vSize, PositionData->data());
+        std::vector<GLubyte> encoded_data;
+
+        if (attribute == 0)
+        {
+            if (!m_quantized)
+            {
+                buffer_sub_data(GL_ARRAY_BUFFER, m_vbo, vOffset + first * m_position_bytes, (last - first) * m_position_bytes, PositionData->data() + first * 3);
+                return;
+            }
+            encoded_data.resize((last - first) * m_position_bytes);
+            for (size_t i = first; i < last; ++i)
+                write_position(i, encoded_data.data() + (i - first) * m_position_bytes);
+            buffer_sub_data(GL_ARRAY_BUFFER, m_vbo, vOffset + first * m_position_bytes, encoded_data.size(), encoded_data.data());
+        }
+        else if (attribute == 1)
+        {
+            if (!m_quantized)
+            {
+                buffer_sub_data(GL_ARRAY_BUFFER, m_vbo, nOffset + first * m_normal_bytes, (last - first) * m_normal_bytes, NormalData->data() + first * 3);
+                return;
+            }
+            encoded_data.resize((last - first) * m_normal_bytes);
+            for (size_t i = first; i < last; ++i)
+                write_normal(i, encoded_data.data() + (i - first) * m_normal_bytes);
+            buffer_sub_data(GL_ARRAY_BUFFER, m_vbo, nOffset + first * m_normal_bytes, encoded_data.size(), encoded_data.data());
+        }
+        else
+        {
+            buffer_sub_data(GL_ARRAY_BUFFER, m_vbo, cOffset + first, last - first, ColorData->data() + first);
+        }
+    }
 
-        if (nSize != 0)
-            Renderer::GL_API()->glBufferSubData(GL_ARRAY_BUFFER, nOffset, nSize, NormalData->data());
+    void VertexArrayObject::upload_vertex_data()
+    {
+        if (m_interleaved)
+        {
+            std::vector<GLubyte> packed_data;
+            pack_interleaved_vertex_range(0, vSize / m_position_bytes, packed_data);
+            if (packed_data.size())
+                buffer_sub_data(GL_ARRAY_BUFFER, m_vbo, 0, packed_data.size(), packed_data.data());
+            return;
+        }
 
-        if (cSize != 0)
-            Renderer::GL_API()->glBufferSubData(GL_ARRAY_BUFFER, cOffset, cSize, ColorData->data());
+        upload_planar_range(0, 0, vSize / m_position_bytes);
+        upload_planar_range(1, 0, nSize / m_normal_bytes);
+        upload_planar_range(2, 0, cSize);
+    }
 
-        // Set vertex attributes pointers
+    void VertexArrayObject::collect_dirty_elements(const uint32_t array_type, const uint32_t dirty_flag, const size_t element_bytes, const size_t element_count,
+                                                   std::vector<std::pair<size_t, size_t>>& element_ranges) const
+    {
+        typedef GeometryDescriptor::PrimitiveSetInstance PrimitiveSet;
+        const PrimitiveSet& primitive_set = *(m_geometry_descriptor->currentPrimitiveSet);
+
+        if (!primitive_set.isDirty(dirty_flag) || element_bytes == 0 || element_count == 0) return;
+
+        const std::vector<PrimitiveSet::DirtyRange>& ranges = primitive_set.get_dirty_ranges(static_cast<PrimitiveSet::VertexArrayType>(array_type));
+        if (ranges.empty())
+        {
+            element_ranges.emplace_back(0, element_count);
+            return;
+        }
+
+        for (const PrimitiveSet::DirtyRange& range : ranges)
+        {
+            const size_t first = range.begin / element_bytes;
+            const size_t last  = std::min(element_count, range.end / element_bytes + (range.end % element_bytes != 0));
+            if (first < last)
+                element_ranges.emplace_back(first, last);
+        }
+    }
+
+    void VertexArrayObject::buffer_sub_data(const GLenum target, const GLuint buffer, const GLintptr offset, const GLsizeiptr size, const void* data)
+    {
+        /// Offsets are relative to the start of this object's range in the (possibly shared) buffer
+        const GLintptr buffer_offset = offset + ((target == GL_ELEMENT_ARRAY_BUFFER) ? m_ibo_offset : m_vbo_offset);
+
+        if (m_streamed)
+            StreamingUploader::GetInstance().upload(buffer, buffer_offset, size, data);
+        else
+            Renderer::GL_API()->glBufferSubData(target, buffer_offset, size, data);
+    }
+
+    const bool VertexArrayObject::use_buffer_arena() const
+    {
+    #ifdef _ENABLE_GPU_BUFFER_ARENA_
+        /// Streamed sets keep private buffers so that their rewrites never touch the shared pages
+        return !m_streamed;
+    #else
+        return false;
+    #endif
+    }
+
+    const bool VertexArrayObject::vertex_storage_matches() const
+    {
+        if (m_vbo == 0 || m_vbo_curr_size != m_vbo_data_size) return false;
+        if (m_vbo_allocation.is_valid() != use_buffer_arena()) return false;
+        return !m_vbo_allocation.is_valid() || (m_vbo_offset % vertex_alignment()) == 0;
+    }
+
+    /// @brief (Re)allocate m_vbo_data_size bytes and leave the buffer bound to GL_ARRAY_BUFFER
+    void VertexArrayObject::allocate_vertex_storage()
+    {
+        delete_vbo();
+
+        if (use_buffer_arena() && m_vbo_data_size)
+        {
+            m_vbo_allocation = GpuBufferArena::GetInstance().allocate(GpuBufferArena::VERTEX_POOL, m_vbo_data_size, vertex_alignment());
+            m_vbo        = m_vbo_allocation.buffer;
+            m_vbo_offset = m_vbo_allocation.offset;
+            Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        }
+        else
+        {
+            Renderer::GL_API()->glGenBuffers(1, &m_vbo);
+            Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+            Renderer::GL_API()->glBufferData(GL_ARRAY_BUFFER, m_vbo_data_size, nullptr, buffer_usage());
+            m_vbo_offset = 0;
+        }
+        m_vbo_curr_size = m_vbo_data_size;
+    }
+
+    /// @brief (Re)allocate index_bytes bytes and leave the buffer bound to GL_ELEMENT_ARRAY_BUFFER
+    void VertexArrayObject::allocate_index_storage(const GLsizeiptr index_bytes)
+    {
+        delete_ibo();
+
+        if (use_buffer_arena() && index_bytes)
+        {
+            m_ibo_allocation = GpuBufferArena::GetInstance().allocate(GpuBufferArena::INDEX_POOL, index_bytes, sizeof(uint32_t));
+            m_ibo        = m_ibo_allocation.buffer;
+            m_ibo_offset = m_ibo_allocation.offset;
+            Renderer::GL_API()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+        }
+        else
+        {
+            Renderer::GL_API()->glGenBuffers(1, &m_ibo);
+            Renderer::GL_API()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+            Renderer::GL_API()->glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_bytes, nullptr, buffer_usage());
+            m_ibo_offset = 0;
+        }
+        m_ibo_bytes = index_bytes;
+    }
+
+    void VertexArrayObject::upload_dirty_vertex_ranges()
+    {
+        typedef GeometryDescriptor::PrimitiveSetInstance PrimitiveSet;
+        const size_t num_vertices = vSize / m_position_bytes;
+
+        std::vector<std::pair<size_t, size_t>> position_ranges, normal_ranges, color_ranges;
+        collect_dirty_elements(PrimitiveSet::POSITION_ARRAY, PrimitiveSet::DIRTY_POSITIONS, 3 * sizeof(float), num_vertices, position_ranges);
+        if (nSize)
+            collect_dirty_elements(PrimitiveSet::NORMAL_ARRAY, PrimitiveSet::DIRTY_NORMALS, 3 * sizeof(float), nSize / m_normal_bytes, normal_ranges);
+        if (cSize)
+            collect_dirty_elements(PrimitiveSet::COLOR_ARRAY, PrimitiveSet::DIRTY_COLORS, sizeof(GLubyte), cSize, color_ranges);
+
+        if (!m_interleaved)
+        {
+            for (const auto& range : position_ranges) upload_planar_range(0, range.first, range.second);
+            for (const auto& range : normal_ranges)   upload_planar_range(1, range.first, range.second);
+            for (const auto& range : color_ranges)    upload_planar_range(2, range.first, range.second);
+            return;
+        }
+
+        /// Interleaved : merge the vertex intervals of all attributes and repack whole vertices
+        std::vector<std::pair<size_t, size_t>> vertex_ranges(position_ranges);
+        vertex_ranges.insert(vertex_ranges.end(), normal_ranges.begin(), normal_ranges.end());
+        for (const auto& range : color_ranges)
+            vertex_ranges.emplace_back(range.first / cComponents, (range.second + cComponents - 1) / cComponents);
+
+        std::sort(vertex_ranges.begin(), vertex_ranges.end());
+
+        std::vector<GLubyte> packed_data;
+        size_t i = 0;
+        while (i < vertex_ranges.size())
+        {
+            size_t first = vertex_ranges[i].first, last = vertex_ranges[i].second;
+            for (++i; i < vertex_ranges.size() && vertex_ranges[i].first <= last; ++i)
+                last = std::max(last, vertex_ranges[i].second);
+
+            last = std::min(last, num_vertices);
+            if (first >= last) continue;
+
+            pack_interleaved_vertex_range(first, last, packed_data);
+            buffer_sub_data(GL_ARRAY_BUFFER, m_vbo, first * m_stride, packed_data.size(), packed_data.data());
+        }
+    }
+
+    VertexArrayObject::UploadedLayout VertexArrayObject::current_layout() const
+    {
+        UploadedLayout layout;
+        layout.interleaved     = m_interleaved;
+        layout.quantized       = m_quantized;
+        layout.streamed        = m_streamed;
+        layout.vSize           = vSize;
+        layout.nSize           = nSize;
+        layout.cSize           = cSize;
+        layout.position_offset = m_position_offset;
+        layout.position_scale  = m_position_scale;
+        return layout;
+    }
+
+    void VertexArrayObject::set_vertex_attribute_pointers()
+    {
+        const GLsizei vStride = m_interleaved ? m_stride : m_position_bytes;
+        const GLsizei nStride = m_interleaved ? m_stride : m_normal_bytes;
+        const GLsizei cStride = m_interleaved ? m_stride : cComponents * sizeof(GLubyte);
+
+        /// Interleaved arena ranges are reached through the base vertex of the draw, planar ones through the pointers
+        const uintptr_t base = (m_interleaved && m_vbo_allocation.is_valid()) ? 0 : static_cast<uintptr_t>(m_vbo_offset);
+
+        // Position -> location 0 (normalized 16 bit when quantized, see get_position_offset/scale)
         if (vSize)
         {
-            Renderer::GL_API()->glVertexAttribPointer(it, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), 0);
-            Renderer::GL_API()->glEnableVertexAttribArray(it);
-            ++it;
+            if (m_quantized)
+                Renderer::GL_API()->glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, vStride, (void*)(base + vOffset));
+            else
+                Renderer::GL_API()->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vStride, (void*)(base + vOffset));
+            Renderer::GL_API()->glEnableVertexAttribArray(0);
         }
-        
         else
         {
             // Throw Some Exception for rehandle the render pass
             // glVertexAttrib3f(0, 0.0f, 0.0f, 0.1f);
         }
 
+        // Normal -> location 1 (2 component octahedral snorm when quantized)
         if (nSize)
         {
-            Renderer::GL_API()->glVertexAttribPointer(it, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)vOffset);
-            Renderer::GL_API()->glEnableVertexAttribArray(it);
-            ++it;
+            if (m_quantized)
+                Renderer::GL_API()->glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, nStride, (void*)(base + nOffset));
+            else
+                Renderer::GL_API()->glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, nStride, (void*)(base + nOffset));
+            Renderer::GL_API()->glEnableVertexAttribArray(1);
         }
-
         else
         {
-            //glVertexAttrib3f(2, 0.0f, 0.0f, 0.1f);
+            Renderer::GL_API()->glDisableVertexAttribArray(1);
         }
 
+        // Color -> location 2
         if (cSize)
         {
-            Renderer::GL_API()->glVertexAttribPointer(it, 3, GL_UNSIGNED_BYTE, GL_FALSE, 3 * sizeof(GLubyte), (void*)nOffset);
-            Renderer::GL_API()->glEnableVertexAttribArray(it);
+            Renderer::GL_API()->glVertexAttribPointer(2, cComponents, GL_UNSIGNED_BYTE, GL_FALSE, cStride, (void*)(base + cOffset));
+            Renderer::GL_API()->glEnableVertexAttribArray(2);
+        }
+        else
+        {
+            Renderer::GL_API()->glDisableVertexAttribArray(2);
+        }
+    }
+
+    void VertexArrayObject::specify_attribute_format()
+    {
+        Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        set_vertex_attribute_pointers();
+        Renderer::GL_API()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+    }
+
+    void VertexArrayObject::create_vbo()
+    {   
+    
+        calculate_offsets();
+        /// @brief Allocate the vertex buffer storage only if the vertex data size (or its arena alignment) has changed
+        /// @note  This is to avoid the reallocation of the VBO for every frame
+        if(!vertex_storage_matches())
+        { 
+           delete_vao();
+           Renderer::GL_API()->glGenVertexArrays(1, &m_vao);
+           GLStateCache::GetInstance().bind_vertex_array(m_vao);
+           allocate_vertex_storage();
         }
         else
         {
-            //Renderer::GL_API()->glVertexAttrib3f(2, 1.0f, 0.0f, 0.0f);
+           GLStateCache::GetInstance().bind_vertex_array(m_vao);
+           Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        }
+
+        // Copy data to VBO
+        upload_vertex_data();
+
+        // Set vertex attributes pointers
+        set_vertex_attribute_pointers();
+        m_uploaded_layout = current_layout();
+
+        // A recreated VAO has lost the instance attributes, the instance buffer itself is unchanged
+        if(m_instance_vbo != 0)
+        {
+            Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_instance_vbo);
+            set_instance_attribute_pointers();
         }
 
         // Unbind VBO
@@ -238,56 +884,107 @@ namespace gridpro_gui
         }
 
       
+      GLenum VertexArrayObject::select_index_type() const
+      {
+          /// 16 bit indices are used for quantized sets whose vertices are all addressable with them
+          const size_t num_vertices = PositionData ? PositionData->size() / 3 : 0;
+          return (m_quantized && num_vertices <= 65536) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+      }
+
+      void VertexArrayObject::upload_index_data()
+      {
+          std::vector<GLubyte> index_data;
+          pack_index_data(index_data);
+          buffer_sub_data(GL_ELEMENT_ARRAY_BUFFER, m_ibo, 0, index_data.size(), index_data.data());
+      }
+
       void VertexArrayObject::create_ibo()
       {   
-          if(m_ibo_curr_size != IndexData->size()) 
-          {
-            delete_ibo();
-            Renderer::GL_API()->glGenBuffers(1, &m_ibo); 
-          }
+          m_index_type = select_index_type();
+          const GLsizeiptr index_bytes = IndexData->size() * (m_index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t));
 
           bind();
-          Renderer::GL_API()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
-          Renderer::GL_API()->glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndexData->size() * sizeof(uint32_t), IndexData->data(), GL_STATIC_DRAW);
+          if(m_ibo == 0 || m_ibo_curr_size != IndexData->size() || m_ibo_bytes != index_bytes || m_ibo_allocation.is_valid() != use_buffer_arena()) 
+            allocate_index_storage(index_bytes);
+          else
+            Renderer::GL_API()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+
+          upload_index_data();
           m_ibo_curr_size = IndexData->size();
           Renderer::GL_API()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
           unbind();
       }
 
 
+      /// @brief Re-upload the vertex data
+      /// @details If the byte layout is unchanged only the dirty intervals recorded by the descriptor are
+      /// @details uploaded with glBufferSubData, otherwise the VBO is rebuilt through create_vbo()
       void VertexArrayObject::update_vbo()
       {
-            Renderer::GL_API()->glBindVertexArray(m_vao);
-            Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+            refresh_descriptor_state();
             calculate_offsets();
-            Renderer::GL_API()->glBufferData(GL_ARRAY_BUFFER, vSize + nSize + cSize, nullptr, GL_STATIC_DRAW);
-    
-            if (vSize)
-                Renderer::GL_API()->glBufferSubData(GL_ARRAY_BUFFER, 0, vSize, PositionData->data());
-    
-            if (nSize)
-                Renderer::GL_API()->glBufferSubData(GL_ARRAY_BUFFER, vSize, nSize, NormalData->data());
+
+            if (!(m_uploaded_layout == current_layout()) || !vertex_storage_matches())
+            {
+                create_vbo();
+                return;
+            }
+
+            GLStateCache::GetInstance().bind_vertex_array(m_vao);
+            Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
     
-            if (cSize)
-                Renderer::GL_API()->glBufferSubData(GL_ARRAY_BUFFER, vSize + nSize, cSize, ColorData->data());
+            if (m_geometry_descriptor != nullptr)
+                upload_dirty_vertex_ranges();
+            else
+                upload_vertex_data();
     
             Renderer::GL_API()->glBindBuffer(GL_ARRAY_BUFFER, 0);
-            Renderer::GL_API()->glBindVertexArray(0);
+            GLStateCache::GetInstance().bind_vertex_array(0);
       }
 
+        /// @brief Re-upload the index data (dirty intervals only if the index count and type are unchanged)
         void VertexArrayObject::update_ibo()
         {
+            refresh_descriptor_state();
             if(IndexData->size() == 0)
                 return;
 
+            if(m_ibo == 0 || m_ibo_curr_size != IndexData->size() || m_index_type != select_index_type() || m_geometry_descriptor == nullptr ||
+               m_ibo_allocation.is_valid() != use_buffer_arena())
+            {
+                create_ibo();
+                return;
+            }
+
+            typedef GeometryDescriptor::PrimitiveSetInstance PrimitiveSet;
+            std::vector<std::pair<size_t, size_t>> index_ranges;
+            collect_dirty_elements(PrimitiveSet::INDEX_ARRAY, PrimitiveSet::DIRTY_INDICES, sizeof(uint32_t), IndexData->size(), index_ranges);
+
             Renderer::GL_API()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
-            Renderer::GL_API()->glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndexData->size() * sizeof(uint32_t), IndexData->data(), GL_STATIC_DRAW);
+            for (const auto& range : index_ranges)
+            {
+                if (m_index_type == GL_UNSIGNED_SHORT)
+                {
+                    std::vector<uint16_t> short_indices(IndexData->begin() + range.first, IndexData->begin() + range.second);
+                    buffer_sub_data(GL_ELEMENT_ARRAY_BUFFER, m_ibo, range.first * sizeof(uint16_t), short_indices.size() * sizeof(uint16_t), short_indices.data());
+                }
+                else
+                {
+                    buffer_sub_data(GL_ELEMENT_ARRAY_BUFFER, m_ibo, range.first * sizeof(uint32_t), (range.second - range.first) * sizeof(uint32_t), IndexData->data() + range.first);
+                }
+            }
             Renderer::GL_API()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         }
 
         void VertexArrayObject::delete_vbo()
         {
-            if(Renderer::GL_API()->glIsBuffer(m_vbo) == GL_TRUE)
+            if(m_vbo_allocation.is_valid())
+            {
+               GpuBufferArena::GetInstance().release(m_vbo_allocation);
+               m_vbo = 0;
+               m_vbo_offset = 0;
+            }
+            else if(Renderer::GL_API()->glIsBuffer(m_vbo) == GL_TRUE)
             {
                Renderer::GL_API()->glDeleteBuffers(1, &m_vbo);
                m_vbo = 0;
@@ -298,7 +995,13 @@ namespace gridpro_gui
 
         void VertexArrayObject::delete_ibo()
         {
-            if(Renderer::GL_API()->glIsBuffer(m_ibo) == GL_TRUE)
+            if(m_ibo_allocation.is_valid())
+            {
+               GpuBufferArena::GetInstance().release(m_ibo_allocation);
+               m_ibo = 0;
+               m_ibo_offset = 0;
+            }
+            else if(Renderer::GL_API()->glIsBuffer(m_ibo) == GL_TRUE)
             {
                Renderer::GL_API()->glDeleteBuffers(1, &m_ibo);
                m_ibo = 0;
@@ -313,6 +1016,7 @@ namespace gridpro_gui
             if(Renderer::GL_API()->glIsVertexArray(m_vao) == GL_TRUE)
             {
                Renderer::GL_API()->glDeleteVertexArrays(1, &m_vao);
+               GLStateCache::GetInstance().on_vertex_array_deleted(m_vao);
                m_vao = 0;
             }
             unbind(); 
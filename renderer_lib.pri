@@ -10,6 +10,13 @@ SOURCES += \
     $$PWD/src/gp_gui_vertex_array_object.cpp \
     $$PWD/src/gp_gui_communications.cpp \
     $$PWD/src/gp_gui_texture.cpp \
+    $$PWD/src/gp_gui_streaming_uploader.cpp \
+    $$PWD/src/gp_gui_commit_pipeline.cpp \
+    $$PWD/src/gp_gui_buffer_arena.cpp \
+    $$PWD/src/gp_gui_batched_render_path.cpp \
+    $$PWD/src/gp_gui_scene_uniform_buffer.cpp \
+    $$PWD/src/gp_gui_ray_pick_engine.cpp \
+    $$PWD/src/gp_gui_scene_graph.cpp \
 
 
 HEADERS += \
@@ -25,6 +32,18 @@ HEADERS += \
     $$PWD/include/gp_gui_vertex_array_object.h \
     $$PWD/include/gp_gui_communications.h \
     $$PWD/include/gp_gui_texture.h \
+    $$PWD/include/gp_gui_streaming_uploader.h \
+    $$PWD/include/gp_gui_commit_pipeline.h \
+    $$PWD/include/gp_gui_buffer_arena.h \
+    $$PWD/include/gp_gui_batched_render_path.h \
+    $$PWD/include/gp_gui_gl_state_cache.h \
+    $$PWD/include/gp_gui_scene_uniform_buffer.h \
+    $$PWD/include/gp_gui_selection_scheduler.h \
+    $$PWD/include/gp_gui_pick_id_allocator.h \
+    $$PWD/include/gp_gui_ray_pick_engine.h \
+    $$PWD/include/gp_gui_slot_map.h \
+    $$PWD/include/gp_gui_entity_key_table.h \
+    $$PWD/include/gp_gui_scene_graph.h \
     
 
 